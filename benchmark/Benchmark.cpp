@@ -0,0 +1,121 @@
+#include "benchmark/Benchmark.h"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+
+namespace
+{
+  std::atomic<std::size_t> AllocationCount(0);
+
+  void* Allocate(std::size_t size)
+  {
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* memory = std::malloc(size > 0 ? size : 1))
+    {
+      return memory;
+    }
+
+    throw std::bad_alloc();
+  }
+}  // anonymous namespace
+
+
+// count heap allocations, see Benchmark::MeasureAllocations()
+void* operator new(std::size_t size)
+{
+  return Allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return Allocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t /*size*/) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t /*size*/) noexcept
+{
+  std::free(memory);
+}
+
+#if defined(__cpp_aligned_new) && !defined(_MSC_VER)
+// over-aligned allocations, e.g. by std::pmr::new_delete_resource()
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+  const std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+
+  if (void* memory = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align))
+  {
+    return memory;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t /*alignment*/) noexcept
+{
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+  std::free(memory);
+}
+#endif
+
+
+std::size_t Benchmark::GetAllocationCount()
+{
+  return AllocationCount.load(std::memory_order_relaxed);
+}
+
+
+int main(int argc, char* argv[])
+{
+  using Suite = std::pair<std::string, void (*)()>;
+
+  const std::vector<Suite> suites =
+  {
+    {"marshaller", &Benchmark::MarshallerBenchmark},
+    {"dispatcher", &Benchmark::DispatcherBenchmark},
+    {"server", &Benchmark::ServerBenchmark},
+    {"transport", &Benchmark::TransportBenchmark},
+    {"connections", &Benchmark::ConnectionBenchmark},
+  };
+
+  // run all suites or only the ones given on the command line
+  const std::vector<std::string> selected(argv + 1, argv + argc);
+
+  for (const auto& suite : suites)
+  {
+    if (selected.empty() || (std::find(selected.begin(), selected.end(), suite.first) != selected.end()))
+    {
+      suite.second();
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+#ifndef CPPRPC_BENCHMARK_BENCHMARK_H
+#define CPPRPC_BENCHMARK_BENCHMARK_H
+
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+#include <boost/format.hpp>
+
+
+namespace Benchmark
+{
+
+  using Clock = std::chrono::steady_clock;
+
+  // minimum duration of a single measurement
+  const std::chrono::milliseconds MeasureDuration(300);
+
+  // calls function repeatedly for at least MeasureDuration, returns average calls per second
+  template <typename Function>
+  double MeasureRate(Function&& function)
+  {
+    // warm up (caches, allocators, lazy initialization)
+    function();
+
+    std::size_t iterations = 0;
+    std::size_t batchSize = 1;
+
+    const auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+
+    do
+    {
+      for (std::size_t i = 0; i < batchSize; ++i)
+      {
+        function();
+      }
+
+      iterations += batchSize;
+      batchSize *= 2;
+
+      elapsed = Clock::now() - start;
+    } while (elapsed < MeasureDuration);
+
+    return static_cast<double>(iterations) / std::chrono::duration<double>(elapsed).count();
+  }
+
+  // calls function concurrently from threadCount threads for at least MeasureDuration, returns total calls per second
+  template <typename Function>
+  double MeasureParallelRate(std::size_t threadCount, Function&& function)
+  {
+    std::atomic<bool> stop(false);
+    std::atomic<std::size_t> iterations(0);
+    std::vector<std::thread> threads;
+
+    const auto start = Clock::now();
+
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+      threads.emplace_back([&]
+        {
+          std::size_t count = 0;
+
+          while (!stop.load(std::memory_order_relaxed))
+          {
+            function();
+            ++count;
+          }
+
+          iterations += count;
+        });
+    }
+
+    std::this_thread::sleep_for(MeasureDuration);
+    stop = true;
+
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+
+    const auto elapsed = Clock::now() - start;
+
+    return static_cast<double>(iterations) / std::chrono::duration<double>(elapsed).count();
+  }
+
+  // 1, 2, 4, ... up to the number of hardware threads
+  inline std::vector<std::size_t> GetThreadCounts()
+  {
+    const std::size_t hardwareThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+    std::vector<std::size_t> threadCounts;
+
+    for (std::size_t threadCount = 1; threadCount < hardwareThreads; threadCount *= 2)
+    {
+      threadCounts.push_back(threadCount);
+    }
+
+    threadCounts.push_back(hardwareThreads);
+
+    return threadCounts;
+  }
+
+  // number of calls to the global operator new so far (replaced in Benchmark.cpp)
+  std::size_t GetAllocationCount();
+
+  // calls function iterations times, returns average number of heap allocations per call
+  template <typename Function>
+  double MeasureAllocations(Function&& function, std::size_t iterations = 1000)
+  {
+    // warm up (caches, allocators, lazy initialization)
+    function();
+
+    const auto start = GetAllocationCount();
+
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+      function();
+    }
+
+    return static_cast<double>(GetAllocationCount() - start) / static_cast<double>(iterations);
+  }
+
+  inline void PrintTitle(const std::string& title)
+  {
+    std::cout << std::endl << title << std::endl << std::string(title.size(), '=') << std::endl;
+  }
+
+  // benchmark suites, see Benchmark.cpp
+  void MarshallerBenchmark();
+  void DispatcherBenchmark();
+  void ServerBenchmark();
+  void TransportBenchmark();
+  void ConnectionBenchmark();
+
+}  // namespace Benchmark
+
+#endif
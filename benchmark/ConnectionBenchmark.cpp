@@ -0,0 +1,181 @@
+#include "benchmark/Benchmark.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <boost/format.hpp>
+
+#include "cpprpc/Interface.h"
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstring>
+
+#include "cpprpc/UnixTransport.h"
+#endif
+
+
+namespace
+{
+
+#if defined(__linux__)
+  using ServerInterface = CppRpc::Interface<CppRpc::InterfaceMode::Server>;
+  using ClientInterface = CppRpc::Interface<CppRpc::InterfaceMode::Client>;
+
+  int Echo(int i) { return i; }
+
+  const std::size_t MaxIdleConnections = 10000;
+
+  // file descriptors kept free for the benchmark itself (transports, I/O engines, ...)
+  const std::size_t ReservedFiles = 64;
+
+  // numeric value of a field of /proc/self/status (e.g. "VmRSS" in KiB or "Threads"), 0 if not found
+  std::size_t ReadProcessStatus(const std::string& field)
+  {
+    std::ifstream status("/proc/self/status");
+
+    std::string line;
+
+    while (std::getline(status, line))
+    {
+      if ((line.compare(0, field.size(), field) == 0) && (line.size() > field.size()) && (line[field.size()] == ':'))
+      {
+        return std::stoul(line.substr(field.size() + 1));
+      }
+    }
+
+    return 0;
+  }
+
+  // raises the limit of open files as far as allowed, every connection needs two of them (client and server side)
+  std::size_t GetMaxConnections()
+  {
+    rlimit limit = {};
+
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0)
+    {
+      limit.rlim_cur = limit.rlim_max;
+
+      setrlimit(RLIMIT_NOFILE, &limit);
+      getrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    return (limit.rlim_cur > ReservedFiles) ? std::min<std::size_t>((limit.rlim_cur - ReservedFiles) / 2, MaxIdleConnections) : 0;
+  }
+
+  // idle clients are plain connected sockets, they do not need a client transport (nor a thread) of their own
+  int Connect(const std::string& path)
+  {
+    CppRpc::Detail::FileDescriptor socket(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+
+    if (socket.Get() < 0)
+    {
+      CppRpc::Detail::ThrowTransportError("Failed to create socket");
+    }
+
+    sockaddr_un address = {};
+
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    if (connect(socket.Get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+      CppRpc::Detail::ThrowTransportError((boost::format("Failed to connect to \"%1%\"") % path).str());
+    }
+
+    return socket.Release();
+  }
+#endif
+
+}  // anonymous namespace
+
+
+namespace Benchmark
+{
+
+  // one server dispatcher (and its single I/O thread) serving a growing number of mostly idle clients next to an active one
+  void ConnectionBenchmark()
+  {
+    PrintTitle("Connections: one server dispatcher serving idle Unix socket clients next to an active one (memory in KiB, rates in calls/s)");
+
+#if defined(__linux__)
+    const std::string path = "/tmp/cpprpc-benchmark.sock";
+
+    const std::size_t maxConnections = GetMaxConnections();
+
+    // before anything was set up, includes the benchmark itself
+    const std::size_t initialRss = ReadProcessStatus("VmRSS");
+
+    CppRpc::UnixServerTransport serverTransport(path, 0);
+    ServerInterface::DispatcherHandle serverDispatcher = CppRpc::MakeDispatcherHandle(serverTransport);
+    ServerInterface serverInterface(serverDispatcher, "ConnectionBenchmark");
+    ServerInterface::Function<int(int)> serverEcho = {serverInterface, "Echo", &Echo};
+
+    CppRpc::UnixClientTransport clientTransport(path, 0);
+    ClientInterface::DispatcherHandle clientDispatcher = CppRpc::MakeDispatcherHandle(clientTransport);
+    ClientInterface clientInterface(clientDispatcher, "ConnectionBenchmark");
+    ClientInterface::Function<int(int)> clientEcho = {clientInterface, "Echo", nullptr};
+
+    // "RSS" is the resident memory of the whole process, "Per conn." its growth per idle connection in bytes
+    std::cout << boost::format("%-20s %10s %10s %8s %14s") % "Idle connections" % "RSS" % "Per conn." % "Threads" % "Call rate" << std::endl;
+
+    std::vector<int> idleSockets;
+
+    idleSockets.reserve(maxConnections);
+
+    std::size_t baseRss = 0;
+
+    for (std::size_t connectionCount : {std::size_t(0), std::size_t(100), std::size_t(1000), maxConnections})
+    {
+      if (connectionCount > maxConnections)
+      {
+        continue;
+      }
+
+      while (idleSockets.size() < connectionCount)
+      {
+        idleSockets.push_back(Connect(path));
+      }
+
+      // accepted by the I/O thread of the server meanwhile (plus the active client)
+      while (serverTransport.GetConnectionCount() < connectionCount + 1)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+
+      const double rate = MeasureRate([&]
+        {
+          clientEcho(4711);
+        });
+
+      const std::size_t rss = ReadProcessStatus("VmRSS");
+
+      if (connectionCount == 0)
+      {
+        baseRss = rss;
+      }
+
+      const double perConnection = (connectionCount > 0) ? 1024.0 * static_cast<double>(rss - std::min(rss, baseRss)) / static_cast<double>(connectionCount) : 0.0;
+
+      std::cout << boost::format("%-20u %10u %10.0f %8u %14.0f") % connectionCount % rss % perConnection % ReadProcessStatus("Threads") % rate << std::endl;
+    }
+
+    std::cout << boost::format("(process RSS before the server was set up: %1% KiB, at most %2% connections within the open file limit)") % initialRss % maxConnections << std::endl;
+
+    for (int socket : idleSockets)
+    {
+      close(socket);
+    }
+#else
+    std::cout << "Unix domain socket transports are not supported on this platform" << std::endl;
+#endif
+  }
+
+}  // namespace Benchmark
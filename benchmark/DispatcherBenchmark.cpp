@@ -0,0 +1,125 @@
+#include "benchmark/Benchmark.h"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <iostream>
+
+#include <boost/mpl/vector.hpp>
+#include <boost/format.hpp>
+
+#include "cpprpc/Interface.h"
+#include "cpprpc/StaticInterface.h"
+
+
+namespace
+{
+
+  using ServerInterface = CppRpc::Interface<CppRpc::InterfaceMode::Server>;
+  using Marshaller = CppRpc::DefaultMarshaller<CppRpc::Dispatcher>;
+
+  int TestFunc3(int i) { return i; }
+
+  constexpr char TestFunc3Name[] = "TestFunc3";
+
+  // serialized call of TestFunc3 of interface
+  CppRpc::Buffer SerializeTestFunc3Call(const ServerInterface::DispatcherHandle& dispatcher, const ServerInterface& interface)
+  {
+    const CppRpc::Buffer resolveResult = dispatcher->DoFunctionCall(Marshaller::SerializeResolveFunction(interface, "TestFunc3"));
+    const CppRpc::Buffer callHeader = Marshaller::SerializeFunctionCallHeader(Marshaller::DeserializeResolveFunctionResult(Marshaller::DeserializeMessageHeader(resolveResult).m_Payload));
+
+    return Marshaller::SerializeFunctionCall<boost::mpl::vector<int>>(CppRpc::Buffer(), callHeader, 0, 4711);
+  }
+
+}  // anonymous namespace
+
+
+namespace Benchmark
+{
+
+  // server side dispatching of a function call (header decoding, function lookup, execution and result encoding) without any transport
+  void DispatcherBenchmark()
+  {
+    PrintTitle("Dispatcher: server side dispatch of TestFunc3 (rates in calls/s)");
+
+    CppRpc::LocalDummyTransport transport;
+    ServerInterface::DispatcherHandle dispatcher = CppRpc::MakeDispatcherHandle(transport.GetServerTransport());
+
+    // "Allocs" is the number of heap allocations per dispatched call
+    std::cout << boost::format("%-20s %14s %8s") % "Registered functions" % "Dispatch rate" % "Allocs" << std::endl;
+
+    for (std::size_t interfaceCount : {1, 10, 100})
+    {
+      // register 10 functions per interface
+      std::vector<std::unique_ptr<ServerInterface>> interfaces;
+      std::vector<std::unique_ptr<ServerInterface::Function<int(int)>>> functions;
+
+      for (std::size_t i = 0; i < interfaceCount; ++i)
+      {
+        interfaces.emplace_back(new ServerInterface(dispatcher, (boost::format("Interface%1%") % i).str()));
+
+        for (std::size_t j = 0; j < 10; ++j)
+        {
+          functions.emplace_back(new ServerInterface::Function<int(int)>(*interfaces.back(), (boost::format("TestFunc%1%") % j).str(), &TestFunc3));
+        }
+      }
+
+      const CppRpc::Buffer callData = SerializeTestFunc3Call(dispatcher, *interfaces[interfaceCount / 2]);
+
+      const double rate = MeasureRate([&]
+        {
+          CppRpc::Buffer resultData = dispatcher->DoFunctionCall(callData);
+        });
+
+      const double allocations = MeasureAllocations([&]
+        {
+          CppRpc::Buffer resultData = dispatcher->DoFunctionCall(callData);
+        });
+
+      std::cout << boost::format("%-20u %14.0f %8.1f") % functions.size() % rate % allocations << std::endl;
+
+      if (interfaceCount == 1)
+      {
+        // function lookup must not serialize concurrent calls
+        for (std::size_t threadCount : GetThreadCounts())
+        {
+          const double parallelRate = MeasureParallelRate(threadCount, [&]
+            {
+              CppRpc::Buffer resultData = dispatcher->DoFunctionCall(callData);
+            });
+
+          std::cout << boost::format("  %2u threads         %14.0f") % threadCount % parallelRate << std::endl;
+        }
+      }
+
+      // deregister before the next round
+      functions.clear();
+    }
+
+    // function declared at compile time (plain function pointer calling TestFunc3 directly) vs. registered at runtime (std::function)
+    std::cout << boost::format("\n%-20s %14s %8s") % "Registration" % "Dispatch rate" % "Allocs" << std::endl;
+
+    ServerInterface dynamicInterface(dispatcher, "Dynamic");
+    ServerInterface::Function<int(int)> dynamicFunction = {dynamicInterface, "TestFunc3", &TestFunc3};
+
+    CppRpc::StaticInterface<CppRpc::StaticFunction<int(int), &TestFunc3, TestFunc3Name>> staticInterface(dispatcher, "Static");
+
+    for (const ServerInterface* interface : {static_cast<const ServerInterface*>(&dynamicInterface), static_cast<const ServerInterface*>(&staticInterface)})
+    {
+      const CppRpc::Buffer callData = SerializeTestFunc3Call(dispatcher, *interface);
+
+      const double rate = MeasureRate([&]
+        {
+          CppRpc::Buffer resultData = dispatcher->DoFunctionCall(callData);
+        });
+
+      const double allocations = MeasureAllocations([&]
+        {
+          CppRpc::Buffer resultData = dispatcher->DoFunctionCall(callData);
+        });
+
+      std::cout << boost::format("%-20s %14.0f %8.1f") % interface->GetName() % rate % allocations << std::endl;
+    }
+  }
+
+}  // namespace Benchmark
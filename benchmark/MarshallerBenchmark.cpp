@@ -0,0 +1,191 @@
+#include "benchmark/Benchmark.h"
+
+#include <string>
+#include <functional>
+#include <map>
+#include <list>
+#include <vector>
+#include <numeric>
+#include <iostream>
+
+#include <boost/function_types/result_type.hpp>
+#include <boost/function_types/parameter_types.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/list.hpp>
+#include <boost/format.hpp>
+
+#include "cpprpc/Interface.h"
+
+
+namespace
+{
+
+  // same signatures as in cpprpc/Test.cpp
+  struct Implementation
+  {
+    static void TestFunc1() {}
+    static int  TestFunc2() { return 1; }
+    static int  TestFunc3(int i) { return i; }
+    static bool TestFunc4(const std::string& str) { return !str.empty(); }
+    static bool TestFunc5(const std::string& str, bool enable) { return enable ? !str.empty() : false; }
+
+    // bulk data, copied as one block by the binary serializer
+    static double SumSamples(const std::vector<double>& samples) { return std::accumulate(samples.begin(), samples.end(), 0.0); }
+    static std::size_t CountSamples(const std::vector<int>& samples) { return samples.size(); }
+
+    using TestFunc6ReturnType = std::map<int, std::map<std::size_t, std::string>>;
+    using TestFunc6ParamType = std::map<int, std::list<std::string>>;
+
+    static TestFunc6ReturnType TestFunc6(const TestFunc6ParamType& input)
+    {
+      TestFunc6ReturnType result;
+
+      for (const auto& list : input)
+      {
+        for (const auto& string : list.second)
+        {
+          result[list.first][string.size()] = string;
+        }
+      }
+
+      return result;
+    }
+
+#ifdef CPPRPC_HAS_PMR
+    using PmrFunc6ParamType = std::pmr::map<int, std::pmr::list<std::pmr::string>>;
+
+    static TestFunc6ReturnType PmrFunc6(const PmrFunc6ParamType& input)
+    {
+      TestFunc6ReturnType result;
+
+      for (const auto& list : input)
+      {
+        for (const auto& string : list.second)
+        {
+          result[list.first][string.size()].assign(string.begin(), string.end());
+        }
+      }
+
+      return result;
+    }
+#endif
+  };
+
+  // measures client side (serialize call + de-serialize result) and server side (de-serialize call + execute + serialize result)
+  template <typename Serializer, typename Signature, typename FunctionPointer, typename... Arguments>
+  void Measure(const std::string& serializerName, const std::string& name, FunctionPointer implementation, const Arguments&... arguments)
+  {
+    using Marshaller = CppRpc::Marshaller<CppRpc::Dispatcher, Serializer>;
+    using ReturnType = typename boost::function_types::result_type<Signature>::type;
+    using ParamTypes = typename boost::function_types::parameter_types<Signature>::type;
+
+    std::function<Signature> function(implementation);
+
+    const CppRpc::Buffer callHeader = Marshaller::SerializeFunctionCallHeader(0);
+    const CppRpc::Buffer callData = Marshaller::template SerializeFunctionCall<ParamTypes>(CppRpc::Buffer(), callHeader, 0, arguments...);
+    CppRpc::Buffer resultData;
+    Marshaller::template DeserializeAndExecuteFunctionCall<ReturnType, ParamTypes>(Marshaller::DeserializeFunctionCall(Marshaller::DeserializeMessageHeader(callData).m_Payload).m_ParameterData, resultData, function);
+
+    const double clientRate = Benchmark::MeasureRate([&]
+      {
+        CppRpc::Buffer data = Marshaller::template SerializeFunctionCall<ParamTypes>(CppRpc::Buffer(), callHeader, callData.size(), arguments...);
+        Marshaller::template DeserializeResult<ReturnType>(resultData);
+      });
+
+    const double clientAllocations = Benchmark::MeasureAllocations([&]
+      {
+        CppRpc::Buffer data = Marshaller::template SerializeFunctionCall<ParamTypes>(CppRpc::Buffer(), callHeader, callData.size(), arguments...);
+      });
+
+    const auto serverCall = [&]
+      {
+        CppRpc::Detail::MessageHeader header = Marshaller::DeserializeMessageHeader(callData);
+        CppRpc::Detail::RemoteFunctionCall functionCall = Marshaller::DeserializeFunctionCall(header.m_Payload);
+        CppRpc::Buffer data;
+        Marshaller::SerializeResultHeader(data, header.m_CorrelationId);
+        Marshaller::template DeserializeAndExecuteFunctionCall<ReturnType, ParamTypes>(functionCall.m_ParameterData, data, function);
+      };
+
+    const double serverRate = Benchmark::MeasureRate(serverCall);
+    const double serverAllocations = Benchmark::MeasureAllocations(serverCall, 100);
+
+    std::cout << boost::format("%-10s %-7s %10u %10u %14.0f %14.0f %12.1f %12.1f") % name % serializerName % callData.size() % resultData.size() % clientRate % serverRate % clientAllocations % serverAllocations << std::endl;
+  }
+
+  template <typename Serializer>
+  void MeasureAll(const std::string& serializerName, const Implementation::TestFunc6ParamType& func6Param)
+  {
+    Measure<Serializer, void()>(serializerName, "TestFunc1", &Implementation::TestFunc1);
+    Measure<Serializer, int()>(serializerName, "TestFunc2", &Implementation::TestFunc2);
+    Measure<Serializer, int(int)>(serializerName, "TestFunc3", &Implementation::TestFunc3, 4711);
+    Measure<Serializer, bool(const std::string&)>(serializerName, "TestFunc4", &Implementation::TestFunc4, std::string("Hallo"));
+    Measure<Serializer, bool(const std::string&, bool)>(serializerName, "TestFunc5", &Implementation::TestFunc5, std::string("foo"), true);
+    Measure<Serializer, Implementation::TestFunc6ReturnType(const Implementation::TestFunc6ParamType&)>(serializerName, "TestFunc6", &Implementation::TestFunc6, func6Param);
+  }
+
+}  // anonymous namespace
+
+
+namespace Benchmark
+{
+
+  void MarshallerBenchmark()
+  {
+    PrintTitle("Marshaller: text vs. binary serializer (sizes in bytes, rates in calls/s)");
+
+    // 100 keys with 10 strings each
+    Implementation::TestFunc6ParamType func6Param;
+
+    for (int key = 0; key < 100; ++key)
+    {
+      for (int value = 0; value < 10; ++value)
+      {
+        func6Param[key].push_back(std::string(static_cast<std::size_t>(value + 1), 'x'));
+      }
+    }
+
+    // "Call allocs" is the number of heap allocations needed to serialize a call (client side),
+    // "Server allocs" the number needed to de-serialize and execute it and serialize the result (server side)
+    std::cout << boost::format("%-10s %-7s %10s %10s %14s %14s %12s %12s") % "Function" % "Format" % "Call size" % "Result" % "Client rate" % "Server rate" % "Call allocs" % "Server allocs" << std::endl;
+
+    MeasureAll<CppRpc::TextSerializer>("text", func6Param);
+    MeasureAll<CppRpc::BinarySerializer>("binary", func6Param);
+
+#ifdef CPPRPC_HAS_PMR
+    // TestFunc6 with std::pmr parameters, de-serialized into the argument arena of the call (binary serializer only)
+    Implementation::PmrFunc6ParamType pmrFunc6Param;
+
+    for (const auto& list : func6Param)
+    {
+      pmrFunc6Param[list.first].assign(list.second.begin(), list.second.end());
+    }
+
+    Measure<CppRpc::BinarySerializer, Implementation::TestFunc6ReturnType(const Implementation::PmrFunc6ParamType&)>("binary", "PmrFunc6", &Implementation::PmrFunc6, pmrFunc6Param);
+#endif
+
+    // TestFunc6 with large inputs, "Function" is the number of keys x strings per key
+    for (int keyCount : {1000, 10000})
+    {
+      Implementation::TestFunc6ParamType largeParam;
+
+      for (int key = 0; key < keyCount; ++key)
+      {
+        for (int value = 0; value < 10; ++value)
+        {
+          // long enough to be allocated (no small string optimization)
+          largeParam[key].push_back(std::string(static_cast<std::size_t>(value + 32), 'x'));
+        }
+      }
+
+      Measure<CppRpc::BinarySerializer, Implementation::TestFunc6ReturnType(const Implementation::TestFunc6ParamType&)>("binary", (boost::format("%1%x10") % keyCount).str(), &Implementation::TestFunc6, largeParam);
+    }
+
+    // arrays of one million samples, throughput is call size times rate
+    const std::vector<double> doubleSamples(1000000, 0.5);
+    const std::vector<int> intSamples(1000000, 4711);
+
+    Measure<CppRpc::BinarySerializer, double(const std::vector<double>&)>("binary", "1M double", &Implementation::SumSamples, doubleSamples);
+    Measure<CppRpc::BinarySerializer, std::size_t(const std::vector<int>&)>("binary", "1M int", &Implementation::CountSamples, intSamples);
+  }
+
+}  // namespace Benchmark
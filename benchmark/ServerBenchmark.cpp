@@ -0,0 +1,350 @@
+#include "benchmark/Benchmark.h"
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <iostream>
+
+#include <boost/mpl/vector.hpp>
+#include <boost/format.hpp>
+
+#include "cpprpc/Interface.h"
+
+
+namespace
+{
+
+  using ServerInterface = CppRpc::Interface<CppRpc::InterfaceMode::Server>;
+  using ClientInterface = CppRpc::Interface<CppRpc::InterfaceMode::Client>;
+  using Marshaller = CppRpc::DefaultMarshaller<CppRpc::Dispatcher>;
+
+  // CPU bound function, roughly 10us per call
+  std::uint64_t Compute(std::uint64_t seed)
+  {
+    std::uint64_t value = seed;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+      value ^= value << 13;
+      value ^= value >> 7;
+      value ^= value << 17;
+    }
+
+    return value;
+  }
+
+  int Echo(int i) { return i; }
+  void Log(int /*i*/) {}
+
+  // number of calls in flight per measurement
+  const std::size_t CallCount = 20000;
+
+  // number of calls in flight per pipelined client round
+  const std::size_t PipelineDepth = 64;
+
+  // sequential round trip and batched (PipelineDepth calls per batch) call rate of function
+  template <typename Function, typename Argument>
+  std::pair<double, double> MeasureCallRates(const ClientInterface::DispatcherHandle& dispatcher, Function& function, Argument argument)
+  {
+    const double roundTripRate = Benchmark::MeasureRate([&]
+      {
+        function(argument);
+      });
+
+    std::vector<decltype(function.AsyncCall(argument))> results;
+
+    results.reserve(PipelineDepth);
+
+    const double batchedRate = PipelineDepth * Benchmark::MeasureRate([&]
+      {
+        {
+          ClientInterface::Batch batch(dispatcher);
+
+          for (std::size_t i = 0; i < PipelineDepth; ++i)
+          {
+            results.push_back(function.AsyncCall(argument));
+          }
+        }
+
+        for (auto& result : results)
+        {
+          result.Get();
+        }
+
+        results.clear();
+      });
+
+    return std::make_pair(roundTripRate, batchedRate);
+  }
+
+}  // anonymous namespace
+
+
+namespace Benchmark
+{
+
+  // end-to-end server throughput with a CPU bound function, all calls are sent at once and then all results are received
+  void ServerBenchmark()
+  {
+    PrintTitle("Server: CPU bound function calls over LocalDummyTransport (rates in calls/s)");
+
+    std::cout << boost::format("%-20s %14s") % "Worker threads" % "Call rate" << std::endl;
+
+    std::vector<std::size_t> workerThreadCounts = GetThreadCounts();
+
+    workerThreadCounts.insert(workerThreadCounts.begin(), 0);
+
+    for (std::size_t workerThreadCount : workerThreadCounts)
+    {
+      CppRpc::LocalDummyTransport transport;
+      ServerInterface::DispatcherHandle dispatcher = CppRpc::MakeDispatcherHandle(transport.GetServerTransport(), workerThreadCount);
+      ServerInterface interface(dispatcher, "ServerBenchmark");
+      ServerInterface::Function<std::uint64_t(std::uint64_t)> compute = {interface, "Compute", &Compute};
+
+      const CppRpc::Buffer resolveResult = dispatcher->DoFunctionCall(Marshaller::SerializeResolveFunction(interface, "Compute"));
+      const CppRpc::Buffer callHeader = Marshaller::SerializeFunctionCallHeader(Marshaller::DeserializeResolveFunctionResult(Marshaller::DeserializeMessageHeader(resolveResult).m_Payload));
+      const CppRpc::Buffer callData = Marshaller::SerializeFunctionCall<boost::mpl::vector<std::uint64_t>>(CppRpc::Buffer(), callHeader, 0, 4711);
+
+      CppRpc::Transport<CppRpc::InterfaceMode::Client>& clientTransport = transport.GetClientTransport();
+
+      const auto start = Clock::now();
+
+      for (std::size_t i = 0; i < CallCount; ++i)
+      {
+        clientTransport.Send(callData);
+      }
+
+      CppRpc::Buffer resultData;
+
+      for (std::size_t i = 0; i < CallCount; ++i)
+      {
+        while (!clientTransport.Receive(resultData));
+      }
+
+      const auto elapsed = Clock::now() - start;
+
+      const std::string label = (workerThreadCount == 0) ? std::string("0 (server thread)") : std::to_string(workerThreadCount);
+
+      std::cout << boost::format("%-20s %14.0f") % label % (CallCount / std::chrono::duration<double>(elapsed).count()) << std::endl;
+    }
+
+    PrintTitle("Server: round trips through the client dispatcher over LocalDummyTransport (rates in calls/s)");
+
+    {
+      CppRpc::LocalDummyTransport transport;
+      ServerInterface::DispatcherHandle serverDispatcher = CppRpc::MakeDispatcherHandle(transport.GetServerTransport());
+      ServerInterface serverInterface(serverDispatcher, "ServerBenchmark");
+      ServerInterface::Function<int(int)> serverEcho = {serverInterface, "Echo", &Echo};
+      ServerInterface::Function<void(int)> serverLog = {serverInterface, "Log", &Log, CppRpc::OneWay};
+
+      ClientInterface::DispatcherHandle clientDispatcher = CppRpc::MakeDispatcherHandle(transport.GetClientTransport());
+      ClientInterface clientInterface(clientDispatcher, "ServerBenchmark");
+      ClientInterface::Function<int(int)> clientEcho = {clientInterface, "Echo", nullptr};
+      ClientInterface::Function<void(int)> clientLog = {clientInterface, "Log", nullptr, CppRpc::OneWay};
+
+      const double sequentialRate = MeasureRate([&]
+        {
+          clientEcho(4711);
+        });
+
+      // keep PipelineDepth calls in flight on the same dispatcher
+      std::vector<CppRpc::AsyncResult<int>> results;
+
+      results.reserve(PipelineDepth);
+
+      const double pipelinedRate = PipelineDepth * MeasureRate([&]
+        {
+          for (std::size_t i = 0; i < PipelineDepth; ++i)
+          {
+            results.push_back(clientEcho.AsyncCall(4711));
+          }
+
+          for (auto& result : results)
+          {
+            result.Get();
+          }
+
+          results.clear();
+        });
+
+      // send PipelineDepth calls as one message
+      const double batchedRate = PipelineDepth * MeasureRate([&]
+        {
+          {
+            ClientInterface::Batch batch(clientDispatcher);
+
+            for (std::size_t i = 0; i < PipelineDepth; ++i)
+            {
+              results.push_back(clientEcho.AsyncCall(4711));
+            }
+          }
+
+          for (auto& result : results)
+          {
+            result.Get();
+          }
+
+          results.clear();
+        });
+
+      // PipelineDepth one-way calls, the final round trip returns after all of them were executed
+      const double oneWayRate = PipelineDepth * MeasureRate([&]
+        {
+          for (std::size_t i = 0; i < PipelineDepth; ++i)
+          {
+            clientLog(4711);
+          }
+
+          clientEcho(4711);
+        });
+
+      std::cout << boost::format("%-20s %14.0f") % "Sequential" % sequentialRate << std::endl;
+      std::cout << boost::format("%-20s %14.0f") % (boost::format("%1% in flight") % PipelineDepth).str() % pipelinedRate << std::endl;
+      std::cout << boost::format("%-20s %14.0f") % (boost::format("Batch of %1%") % PipelineDepth).str() % batchedRate << std::endl;
+      std::cout << boost::format("%-20s %14.0f") % "One-way" % oneWayRate << std::endl;
+    }
+
+    PrintTitle("Server: trivial (Echo) and CPU bound (Compute) calls by execution policy, with worker threads (rates in calls/s)");
+
+    {
+      using Policy = std::pair<std::string, CppRpc::ExecutionPolicy>;
+
+      const std::size_t workerThreadCount = GetThreadCounts().back();
+
+      std::cout << boost::format("%-20s %14s %14s") % "Function / policy" % "Round trip" % (boost::format("Batch of %1%") % PipelineDepth).str() << std::endl;
+
+      for (const Policy& policy : {Policy("Offload", CppRpc::ExecutionPolicy::Offload), Policy("Inline", CppRpc::ExecutionPolicy::Inline), Policy("Adaptive", CppRpc::ExecutionPolicy::Adaptive)})
+      {
+        CppRpc::LocalDummyTransport transport;
+        ServerInterface::DispatcherHandle serverDispatcher = CppRpc::MakeDispatcherHandle(transport.GetServerTransport(), workerThreadCount);
+        ServerInterface serverInterface(serverDispatcher, "ServerBenchmark");
+        ServerInterface::Function<int(int)> serverEcho = {serverInterface, "Echo", &Echo, policy.second};
+        ServerInterface::Function<std::uint64_t(std::uint64_t)> serverCompute = {serverInterface, "Compute", &Compute, policy.second};
+
+        ClientInterface::DispatcherHandle clientDispatcher = CppRpc::MakeDispatcherHandle(transport.GetClientTransport());
+        ClientInterface clientInterface(clientDispatcher, "ServerBenchmark");
+        ClientInterface::Function<int(int)> clientEcho = {clientInterface, "Echo", nullptr};
+        ClientInterface::Function<std::uint64_t(std::uint64_t)> clientCompute = {clientInterface, "Compute", nullptr};
+
+        for (const auto& rates : {std::make_pair(std::string("Echo"), MeasureCallRates(clientDispatcher, clientEcho, 4711)),
+                                  std::make_pair(std::string("Compute"), MeasureCallRates(clientDispatcher, clientCompute, 4711))})
+        {
+          std::cout << boost::format("%-20s %14.0f %14.0f") % (rates.first + " / " + policy.first) % rates.second.first % rates.second.second << std::endl;
+        }
+      }
+    }
+
+    PrintTitle("Server: start and stop of an idle dispatcher over LocalDummyTransport (times in us)");
+
+    {
+      CppRpc::LocalDummyTransport transport;
+
+      // destruction wakes up the receiving thread blocked in the transport, see Transport::Interrupt()
+      const double rate = MeasureRate([&]
+        {
+          ServerInterface::DispatcherHandle serverDispatcher = CppRpc::MakeDispatcherHandle(transport.GetServerTransport());
+        });
+
+      std::cout << boost::format("%-20s %14.1f") % "Start and stop" % (1000000.0 / rate) << std::endl;
+    }
+
+    PrintTitle("Server: Echo calls over one LocalDummyTransport per shard, batches of 64 from one client per shard (rates in calls/s)");
+
+    // clients run on the same cores as the shards, "Speedup" is relative to a single shard
+    std::cout << boost::format("%-20s %14s %14s %8s") % "Shards" % "Shared" % "Shard per core" % "Speedup" << std::endl;
+
+    double singleShardRate = 0.0;
+
+    for (std::size_t shardCount : GetThreadCounts())
+    {
+      double rates[2] = {};
+
+      for (CppRpc::ServerMode serverMode : {CppRpc::ServerMode::Shared, CppRpc::ServerMode::ShardPerCore})
+      {
+        std::vector<std::unique_ptr<CppRpc::LocalDummyTransport>> transports;
+
+        for (std::size_t i = 0; i < shardCount; ++i)
+        {
+          transports.emplace_back(new CppRpc::LocalDummyTransport());
+        }
+
+        ServerInterface::DispatcherHandle serverDispatcher = CppRpc::MakeDispatcherHandle(transports.front()->GetServerTransport(), 0, serverMode);
+
+        for (std::size_t i = 1; i < shardCount; ++i)
+        {
+          serverDispatcher->AddTransport(transports[i]->GetServerTransport());
+        }
+
+        ServerInterface serverInterface(serverDispatcher, "ServerBenchmark");
+        ServerInterface::Function<int(int)> serverEcho = {serverInterface, "Echo", &Echo};
+
+        std::atomic<bool> stop(false);
+        std::atomic<std::size_t> calls(0);
+        std::vector<std::thread> clients;
+
+        const auto start = Clock::now();
+
+        for (std::size_t i = 0; i < shardCount; ++i)
+        {
+          clients.emplace_back([&, i]
+            {
+              ClientInterface::DispatcherHandle clientDispatcher = CppRpc::MakeDispatcherHandle(transports[i]->GetClientTransport());
+              ClientInterface clientInterface(clientDispatcher, "ServerBenchmark");
+              ClientInterface::Function<int(int)> clientEcho = {clientInterface, "Echo", nullptr};
+
+              std::vector<CppRpc::AsyncResult<int>> results;
+
+              results.reserve(PipelineDepth);
+
+              std::size_t count = 0;
+
+              while (!stop.load(std::memory_order_relaxed))
+              {
+                {
+                  ClientInterface::Batch batch(clientDispatcher);
+
+                  for (std::size_t j = 0; j < PipelineDepth; ++j)
+                  {
+                    results.push_back(clientEcho.AsyncCall(4711));
+                  }
+                }
+
+                for (auto& result : results)
+                {
+                  result.Get();
+                }
+
+                results.clear();
+
+                count += PipelineDepth;
+              }
+
+              calls += count;
+            });
+        }
+
+        std::this_thread::sleep_for(MeasureDuration);
+        stop = true;
+
+        for (auto& client : clients)
+        {
+          client.join();
+        }
+
+        rates[serverMode == CppRpc::ServerMode::ShardPerCore] = static_cast<double>(calls) / std::chrono::duration<double>(Clock::now() - start).count();
+      }
+
+      if (shardCount == 1)
+      {
+        singleShardRate = rates[1];
+      }
+
+      std::cout << boost::format("%-20u %14.0f %14.0f %8.2f") % shardCount % rates[0] % rates[1] % (rates[1] / singleShardRate) << std::endl;
+    }
+  }
+
+}  // namespace Benchmark
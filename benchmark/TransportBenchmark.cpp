@@ -0,0 +1,199 @@
+#include "benchmark/Benchmark.h"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <exception>
+#include <iostream>
+
+#include <boost/format.hpp>
+
+#include "cpprpc/Interface.h"
+#include "cpprpc/TcpTransport.h"
+#include "cpprpc/SharedMemoryTransport.h"
+#include "cpprpc/UnixTransport.h"
+
+
+namespace
+{
+
+  using ServerInterface = CppRpc::Interface<CppRpc::InterfaceMode::Server>;
+  using ClientInterface = CppRpc::Interface<CppRpc::InterfaceMode::Client>;
+
+  int Echo(int i) { return i; }
+  std::size_t Size(const std::string& data) { return data.size(); }
+
+  // number of calls in flight per pipelined client round
+  const std::size_t PipelineDepths[] = {64, 1024};
+
+  // payload of a bulk call
+  const std::size_t PayloadSizes[] = {64 * 1024, 1024 * 1024};
+
+  // bulk payloads are handed over as memfd by the "Unix socket (memfd)" transport
+  const std::size_t UnixFileThreshold = 32 * 1024;
+
+  // size of a ping-pong message
+  const std::size_t PingSize = 64;
+
+  // round trip latency of the bare transports (no dispatcher), the server thread echoes every message until it receives an empty one
+  double MeasurePingPong(CppRpc::Transport<CppRpc::InterfaceMode::Server>& serverTransport, CppRpc::Transport<CppRpc::InterfaceMode::Client>& clientTransport)
+  {
+    std::thread echo([&]
+      {
+        CppRpc::Buffer message;
+
+        for (;;)
+        {
+          if (serverTransport.Receive(message))
+          {
+            if (message.empty())
+            {
+              return;
+            }
+
+            serverTransport.Send(message);
+          }
+        }
+      });
+
+    const CppRpc::Buffer ping(PingSize, 0x42);
+    CppRpc::Buffer pong;
+
+    const double rate = Benchmark::MeasureRate([&]
+      {
+        clientTransport.Send(ping);
+
+        while (!clientTransport.Receive(pong))
+        {}
+      });
+
+    clientTransport.Send(CppRpc::Buffer());
+
+    echo.join();
+
+    return 1000000.0 / rate;
+  }
+
+  // ping-pong and round trip latency, pipelined call rate and bulk throughput through the given pair of transports
+  void MeasureTransport(const std::string& name, CppRpc::Transport<CppRpc::InterfaceMode::Server>& serverTransport, CppRpc::Transport<CppRpc::InterfaceMode::Client>& clientTransport)
+  {
+    // before the dispatchers start receiving
+    const double pingPongLatency = MeasurePingPong(serverTransport, clientTransport);
+
+    ServerInterface::DispatcherHandle serverDispatcher = CppRpc::MakeDispatcherHandle(serverTransport);
+    ServerInterface serverInterface(serverDispatcher, "TransportBenchmark");
+    ServerInterface::Function<int(int)> serverEcho = {serverInterface, "Echo", &Echo};
+    ServerInterface::Function<std::size_t(const std::string&)> serverSize = {serverInterface, "Size", &Size};
+
+    ClientInterface::DispatcherHandle clientDispatcher = CppRpc::MakeDispatcherHandle(clientTransport);
+    ClientInterface clientInterface(clientDispatcher, "TransportBenchmark");
+    ClientInterface::Function<int(int)> clientEcho = {clientInterface, "Echo", nullptr};
+    ClientInterface::Function<std::size_t(const std::string&)> clientSize = {clientInterface, "Size", nullptr};
+
+    const double sequentialRate = Benchmark::MeasureRate([&]
+      {
+        clientEcho(4711);
+      });
+
+    std::vector<double> pipelinedRates;
+
+    for (std::size_t pipelineDepth : PipelineDepths)
+    {
+      std::vector<CppRpc::AsyncResult<int>> results;
+
+      results.reserve(pipelineDepth);
+
+      pipelinedRates.push_back(pipelineDepth * Benchmark::MeasureRate([&]
+        {
+          for (std::size_t i = 0; i < pipelineDepth; ++i)
+          {
+            results.push_back(clientEcho.AsyncCall(4711));
+          }
+
+          for (auto& result : results)
+          {
+            result.Get();
+          }
+
+          results.clear();
+        }));
+    }
+
+    std::vector<double> bulkThroughputs;
+
+    for (std::size_t payloadSize : PayloadSizes)
+    {
+      const std::string payload(payloadSize, 'x');
+
+      bulkThroughputs.push_back(payloadSize * Benchmark::MeasureRate([&]
+        {
+          clientSize(payload);
+        }) / (1024 * 1024));
+    }
+
+    std::cout << boost::format("%-24s %14.2f %14.2f %14.0f %14.0f %14.1f %14.1f") % name % pingPongLatency % (1000000.0 / sequentialRate) % pipelinedRates[0] % pipelinedRates[1] % bulkThroughputs[0] % bulkThroughputs[1] << std::endl;
+  }
+
+}  // anonymous namespace
+
+
+namespace Benchmark
+{
+
+  // compares the in-process transport with real transports
+  void TransportBenchmark()
+  {
+    PrintTitle("Transport: ping-pong and call round trip latency, pipelined call rates and bulk throughput (TCP over loopback, same host)");
+
+    std::cout << boost::format("%-24s %14s %14s %14s %14s %14s %14s") % "Transport" % "Ping-pong (us)" % "Latency (us)"
+                                                                      % (boost::format("Calls/s (%1%)") % PipelineDepths[0]).str()
+                                                                      % (boost::format("Calls/s (%1%)") % PipelineDepths[1]).str()
+                                                                      % (boost::format("MiB/s (%1%K)") % (PayloadSizes[0] / 1024)).str()
+                                                                      % (boost::format("MiB/s (%1%K)") % (PayloadSizes[1] / 1024)).str() << std::endl;
+
+    {
+      CppRpc::LocalDummyTransport transport;
+
+      MeasureTransport("LocalDummyTransport", transport.GetServerTransport(), transport.GetClientTransport());
+    }
+
+#if defined(__linux__)
+    {
+      CppRpc::SharedMemoryServerTransport serverTransport("/cpprpc-benchmark");
+      CppRpc::SharedMemoryClientTransport clientTransport("/cpprpc-benchmark");
+
+      MeasureTransport("Shared memory", serverTransport, clientTransport);
+    }
+
+    using FileThreshold = std::pair<std::string, std::size_t>;
+
+    for (const FileThreshold& fileThreshold : {FileThreshold("Unix socket", 0), FileThreshold("Unix socket (memfd)", UnixFileThreshold)})
+    {
+      CppRpc::UnixServerTransport serverTransport("/tmp/cpprpc-benchmark.sock", fileThreshold.second);
+      CppRpc::UnixClientTransport clientTransport("/tmp/cpprpc-benchmark.sock", fileThreshold.second);
+
+      MeasureTransport(fileThreshold.first, serverTransport, clientTransport);
+    }
+
+    using IoEngine = std::pair<std::string, CppRpc::IoEngineType>;
+
+    for (const IoEngine& ioEngine : {IoEngine("TCP epoll", CppRpc::IoEngineType::Epoll), IoEngine("TCP io_uring", CppRpc::IoEngineType::IoUring)})
+    {
+      try
+      {
+        CppRpc::TcpServerTransport serverTransport(0, "127.0.0.1", CppRpc::TcpDefaultReceiveTimeout, ioEngine.second);
+        CppRpc::TcpClientTransport clientTransport("127.0.0.1", serverTransport.GetPort(), CppRpc::TcpDefaultReceiveTimeout, ioEngine.second);
+
+        MeasureTransport(ioEngine.first, serverTransport, clientTransport);
+      }
+
+      catch (const std::exception& exception)
+      {
+        std::cout << boost::format("%-24s %s") % ioEngine.first % exception.what() << std::endl;
+      }
+    }
+#endif
+  }
+
+}  // namespace Benchmark
@@ -0,0 +1,160 @@
+#ifndef CPPRPC_ARGUMENTARENA_H
+#define CPPRPC_ARGUMENTARENA_H
+
+#pragma once
+
+#include <type_traits>
+#include <memory>
+#include <cstddef>
+#include <cassert>
+
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/or.hpp>
+#include <boost/mpl/fold.hpp>
+#include <boost/mpl/placeholders.hpp>
+#include <boost/noncopyable.hpp>
+
+// C++17 polymorphic allocators (std::pmr)
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && ((__cplusplus >= 201703L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L)))
+#include <memory_resource>
+#endif
+#endif
+
+#if defined(__cpp_lib_memory_resource)
+#define CPPRPC_HAS_PMR
+#endif
+
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+    namespace Detail
+    {
+
+#ifdef CPPRPC_HAS_PMR
+
+      // true for parameter types de-serialized into the argument arena, i.e. types taking a std::pmr::polymorphic_allocator
+      // (std::pmr containers and user types with a matching allocator_type)
+      template <typename T>
+      struct UsesArgumentArena : std::uses_allocator<std::remove_cv_t<std::remove_reference_t<T>>, std::pmr::polymorphic_allocator<std::byte>>
+      {};
+
+      // monotonic arena for the de-serialized arguments of one call, everything is released at once when it goes out of scope
+      //
+      // arenas of one thread are nested, the outermost one starts with a block kept per thread, i.e. small argument sets need no heap allocation at all
+      class ArgumentArena : boost::noncopyable
+      {
+        public:
+          ArgumentArena()
+          : m_Previous(GetCurrent()),
+            m_NestedBlock((m_Previous != nullptr) ? new std::byte[BlockSize] : nullptr),
+            m_Resource((m_NestedBlock != nullptr) ? m_NestedBlock.get() : GetThreadBlock(), BlockSize)
+          {
+            GetCurrent() = this;
+          }
+
+          ~ArgumentArena()
+          {
+            assert(GetCurrent() == this);
+
+            GetCurrent() = m_Previous;
+          }
+
+          std::pmr::memory_resource* GetResource() { return &m_Resource; }
+
+          // innermost arena of the current thread, nullptr if none
+          static ArgumentArena*& GetCurrent()
+          {
+            thread_local ArgumentArena* current = nullptr;
+
+            return current;
+          }
+
+        private:
+          // further memory is taken from the global heap in growing chunks
+          static const std::size_t BlockSize = 16 * 1024;
+
+          ArgumentArena*                      m_Previous;
+          std::unique_ptr<std::byte[]>        m_NestedBlock;  // block of a nested arena, the thread's block is in use by an outer one
+          std::pmr::monotonic_buffer_resource m_Resource;
+
+          static std::byte* GetThreadBlock()
+          {
+            thread_local std::unique_ptr<std::byte[]> block(new std::byte[BlockSize]);
+
+            return block.get();
+          }
+      };
+
+      // constructs a parameter, allocator aware types take their memory from the current argument arena (if any)
+      template <typename T>
+      T MakeArgument(std::true_type /*usesArena*/)
+      {
+        ArgumentArena* arena = ArgumentArena::GetCurrent();
+
+        if (arena == nullptr)
+        {
+          return T();
+        }
+
+        const std::pmr::polymorphic_allocator<std::byte> allocator(arena->GetResource());
+
+        // uses-allocator construction, leading or trailing allocator argument
+        if constexpr (std::is_constructible<T, std::allocator_arg_t, const std::pmr::polymorphic_allocator<std::byte>&>::value)
+        {
+          return T(std::allocator_arg, allocator);
+        }
+        else
+        {
+          return T(allocator);
+        }
+      }
+
+#else
+
+      template <typename T>
+      struct UsesArgumentArena : std::false_type
+      {};
+
+#endif
+
+      template <typename T>
+      T MakeArgument(std::false_type /*usesArena*/)
+      {
+        return T();
+      }
+
+      template <typename T>
+      T MakeArgument()
+      {
+        return MakeArgument<T>(std::integral_constant<bool, UsesArgumentArena<T>::value>());
+      }
+
+      // true if any of the parameter types (MPL sequence) uses the argument arena
+      template <typename ParameterTypes>
+      struct AnyUsesArgumentArena
+      : boost::mpl::fold<ParameterTypes, boost::mpl::false_, boost::mpl::or_<boost::mpl::_1, UsesArgumentArena<boost::mpl::_2>>>::type
+      {};
+
+      // argument arena for calls of functions with allocator aware parameters, nothing otherwise
+      template <bool UsesArena>
+      struct ArgumentArenaScope
+      {
+        ArgumentArenaScope() {}
+      };
+
+#ifdef CPPRPC_HAS_PMR
+      template <>
+      struct ArgumentArenaScope<true>
+      {
+        ArgumentArena m_Arena;
+      };
+#endif
+
+    }  // namespace Detail
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif
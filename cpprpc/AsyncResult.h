@@ -0,0 +1,187 @@
+#ifndef CPPRPC_ASYNCRESULT_H
+#define CPPRPC_ASYNCRESULT_H
+
+#pragma once
+
+#include <future>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <exception>
+#include <cassert>
+
+#include <boost/noncopyable.hpp>
+
+// C++20 coroutine support (co_await AsyncResult<T>)
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+#include <coroutine>
+#define CPPRPC_HAS_COROUTINES
+#endif
+
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+    namespace Detail
+    {
+
+      // shared between AsyncResult<T> and the completion handler of the call
+      template <typename T>
+      class AsyncState : boost::noncopyable
+      {
+        public:
+          AsyncState()
+          : m_Promise(), m_Future(m_Promise.get_future()), m_Mutex(), m_Ready(false), m_Continuation()
+          {}
+
+          // sets the value returned by function (or the exception thrown by it) and runs a continuation set before
+          template <typename Function>
+          void Complete(Function&& function)
+          {
+            try
+            {
+              PromiseHelper<T>::SetValue(m_Promise, std::forward<Function>(function));
+            }
+
+            catch (...)
+            {
+              m_Promise.set_exception(std::current_exception());
+            }
+
+            std::function<void()> continuation;
+
+            {
+              std::lock_guard<std::mutex> lock(m_Mutex);
+
+              m_Ready = true;
+              continuation = std::move(m_Continuation);
+            }
+
+            if (continuation)
+            {
+              continuation();
+            }
+          }
+
+          // returns false (and does not store continuation) if the result is already available
+          bool SetContinuation(std::function<void()> continuation)
+          {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            assert(!m_Continuation);
+
+            if (m_Ready)
+            {
+              return false;
+            }
+
+            m_Continuation = std::move(continuation);
+
+            return true;
+          }
+
+          std::future<T>& GetFuture() { return m_Future; }
+
+        private:
+          std::promise<T>       m_Promise;
+          std::future<T>        m_Future;
+          std::mutex            m_Mutex;         // guards m_Ready and m_Continuation
+          bool                  m_Ready;         // set after the result, decides who runs the continuation
+          std::function<void()> m_Continuation;
+
+          template <typename R, typename Dummy = void>
+          struct PromiseHelper
+          {
+            template <typename Function>
+            static void SetValue(std::promise<R>& promise, Function&& function)
+            {
+              promise.set_value(function());
+            }
+          };
+
+          // spezialisation for void
+          template <typename Dummy>
+          struct PromiseHelper<void, Dummy>
+          {
+            template <typename Function>
+            static void SetValue(std::promise<void>& promise, Function&& function)
+            {
+              function();
+              promise.set_value();
+            }
+          };
+      };
+
+    }  // namespace Detail
+
+
+    // result of an asynchronous remote function call, see Function::AsyncCall()
+    //
+    // completed on the receive thread of the dispatcher, no thread waits for the result unless Get() or Wait() is called;
+    // co_await resumes the awaiting coroutine on the receive thread, it must not do synchronous calls through the same dispatcher
+    template <typename T>
+    class AsyncResult
+    {
+      public:
+        explicit AsyncResult(std::shared_ptr<Detail::AsyncState<T>> state)
+        : m_State(std::move(state))
+        {
+          assert(m_State);
+        }
+
+        AsyncResult(AsyncResult&&) = default;
+        AsyncResult& operator=(AsyncResult&&) = default;
+
+        AsyncResult(const AsyncResult&) = delete;
+        AsyncResult& operator=(const AsyncResult&) = delete;
+
+        // blocks until the result is available, returns the return value or throws the exception of the call, must only be called once
+        T Get()
+        {
+          return m_State->GetFuture().get();
+        }
+
+        void Wait() const
+        {
+          m_State->GetFuture().wait();
+        }
+
+        template <typename Rep, typename Period>
+        std::future_status WaitFor(const std::chrono::duration<Rep, Period>& timeout) const
+        {
+          return m_State->GetFuture().wait_for(timeout);
+        }
+
+        bool IsReady() const
+        {
+          return m_State->GetFuture().wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+#ifdef CPPRPC_HAS_COROUTINES
+        // awaitable interface
+        bool await_ready() const
+        {
+          return IsReady();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+          return m_State->SetContinuation([handle] { handle.resume(); });
+        }
+
+        T await_resume()
+        {
+          return Get();
+        }
+#endif
+
+      private:
+        std::shared_ptr<Detail::AsyncState<T>> m_State;
+    };
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif
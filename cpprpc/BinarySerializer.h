@@ -0,0 +1,821 @@
+#ifndef CPPRPC_BINARYSERIALIZER_H
+#define CPPRPC_BINARYSERIALIZER_H
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <deque>
+#include <set>
+#include <map>
+#include <unordered_set>
+#include <unordered_map>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <memory>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/empty.hpp>
+#include <boost/mpl/front.hpp>
+#include <boost/mpl/pop_front.hpp>
+#include <boost/predef/other/endian.h>
+#include <boost/variant/variant.hpp>
+#include <boost/variant/static_visitor.hpp>
+#include <boost/variant/apply_visitor.hpp>
+#include <boost/serialization/version.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/is_bitwise_serializable.hpp>
+#include <boost/format.hpp>
+
+#include "cpprpc/Types.h"
+#include "cpprpc/Exception.h"
+
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    // T has no padding bytes, specialize it (as std::true_type) for types the compiler can not prove padding free, e.g. with floating point
+    // members or before C++17; see Detail::IsBitwiseObject
+    template <typename T>
+    struct IsPaddingFree
+#if defined(__cpp_lib_has_unique_object_representations)
+    : std::integral_constant<bool, std::has_unique_object_representations_v<T>>
+#else
+    : std::false_type
+#endif
+    {};
+
+
+    namespace Detail
+    {
+
+      // compact binary encoding:
+      //  - arithmetic types and enums are written fixed size, little-endian
+      //  - sizes (string length, element counts, variant index) are written as LEB128 varint
+      //  - trivially copyable user types declared with BOOST_IS_BITWISE_SERIALIZABLE() are written as raw bytes, in their native layout,
+      //    if they are padding free (see IsPaddingFree) or have no serialize(); others use serialize(), their padding bytes would leak
+      //    memory contents of the sender and make the encoding of equal values differ
+      //  - everything else is forwarded to boost::serialization's serialize() (free or member function)
+      //
+      // both peers must agree on the size of the used arithmetic types (no normalization of long, size_t, ...) and the layout of bitwise types
+      //
+      // std::vector and std::array of bulk types (see IsBulkSerializable) are written and read as one block, same encoding as element by element
+
+      // user types declared with BOOST_IS_BITWISE_SERIALIZABLE()
+      template <typename T>
+      struct IsDeclaredBitwiseObject
+      : std::integral_constant<bool, std::is_class<T>::value && std::is_trivially_copyable<T>::value && boost::serialization::is_bitwise_serializable<T>::value>
+      {};
+
+      template <typename...>
+      struct MakeVoid
+      {
+        using type = void;
+      };
+
+      class BinaryOArchive;
+
+      // T provides serialize(), as member or free function (found by ADL)
+      template <typename T, typename = void>
+      struct HasMemberSerialize : std::false_type {};
+
+      template <typename T>
+      struct HasMemberSerialize<T, typename MakeVoid<decltype(std::declval<T&>().serialize(std::declval<BinaryOArchive&>(), 0u))>::type> : std::true_type {};
+
+      template <typename T, typename = void>
+      struct HasFreeSerialize : std::false_type {};
+
+      template <typename T>
+      struct HasFreeSerialize<T, typename MakeVoid<decltype(serialize(std::declval<BinaryOArchive&>(), std::declval<T&>(), 0u))>::type> : std::true_type {};
+
+      // user types written as raw bytes, declared bitwise types with padding use serialize() if they have one (they are still written as
+      // raw bytes, padding included, otherwise)
+      template <typename T>
+      struct IsBitwiseObject
+      : std::integral_constant<bool, IsDeclaredBitwiseObject<T>::value && (IsPaddingFree<T>::value || !(HasMemberSerialize<T>::value || HasFreeSerialize<T>::value))>
+      {};
+
+      // element types copied as a block, arithmetic types (bool is checked element by element) and enums as long as no byte swap is needed
+      template <typename T>
+      struct IsBulkSerializable
+      : std::integral_constant<bool, IsBitwiseObject<T>::value ||
+                                     (((std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) || std::is_enum<T>::value) && (BOOST_ENDIAN_LITTLE_BYTE || (sizeof(T) == 1)))>
+      {};
+
+      class BinaryOArchive
+      {
+        public:
+          // required by boost::serialization::split_member / split_free
+          using is_saving  = boost::mpl::true_;
+          using is_loading = boost::mpl::false_;
+
+          // data gets appended to buffer
+          explicit BinaryOArchive(Buffer& buffer)
+          : m_Buffer(buffer)
+          {}
+
+          BinaryOArchive(const BinaryOArchive&) = delete;
+          BinaryOArchive& operator=(const BinaryOArchive&) = delete;
+
+          template <typename T>
+          BinaryOArchive& operator<<(const T& data)
+          {
+            Save(data);
+            return *this;
+          }
+
+          template <typename T>
+          BinaryOArchive& operator&(const T& data)
+          {
+            return *this << data;
+          }
+
+          void WriteBytes(const void* data, std::size_t size)
+          {
+            if (size > 0)
+            {
+              const auto offset = m_Buffer.size();
+
+              m_Buffer.resize(offset + size);
+              std::memcpy(m_Buffer.data() + offset, data, size);
+            }
+          }
+
+          void WriteSize(std::uint64_t size)
+          {
+            Byte data[10];
+            std::size_t length = 0;
+
+            do
+            {
+              data[length] = static_cast<Byte>(size & 0x7f);
+              size >>= 7;
+
+              if (size != 0)
+              {
+                data[length] |= 0x80;
+              }
+
+              ++length;
+            } while (size != 0);
+
+            WriteBytes(data, length);
+          }
+
+          Buffer& GetBuffer() { return m_Buffer; }
+
+        private:
+          Buffer& m_Buffer;
+
+          template <typename T>
+          void Save(const T& data)
+          {
+            SaveHelper(data, std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value>());
+          }
+
+          // arithmetic types and enums
+          template <typename T>
+          void SaveHelper(const T& data, std::true_type /*isArithmetic*/)
+          {
+            SaveArithmetic(data);
+          }
+
+          template <typename T>
+          void SaveHelper(const T& data, std::false_type /*isArithmetic*/)
+          {
+            SaveObject(data, IsBitwiseObject<T>());
+          }
+
+          template <typename T>
+          void SaveObject(const T& data, std::true_type /*isBitwise*/)
+          {
+            WriteBytes(&data, sizeof(data));
+          }
+
+          // user types, use boost::serialization
+          template <typename T>
+          void SaveObject(const T& data, std::false_type /*isBitwise*/)
+          {
+            boost::serialization::serialize_adl(*this, const_cast<T&>(data), boost::serialization::version<T>::value);
+          }
+
+          void SaveArithmetic(bool data)
+          {
+            const Byte byte = data ? 1 : 0;
+            WriteBytes(&byte, sizeof(byte));
+          }
+
+          template <typename T>
+          void SaveArithmetic(const T& data)
+          {
+#if BOOST_ENDIAN_LITTLE_BYTE
+            WriteBytes(&data, sizeof(data));
+#else
+            Byte bytes[sizeof(T)];
+            const Byte* source = reinterpret_cast<const Byte*>(&data);
+
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+            {
+              bytes[i] = source[sizeof(T) - 1 - i];
+            }
+
+            WriteBytes(bytes, sizeof(bytes));
+#endif
+          }
+
+          template <typename Char, typename Traits, typename Allocator>
+          void Save(const std::basic_string<Char, Traits, Allocator>& data)
+          {
+            WriteSize(data.size());
+
+            // TODO: byte swap for multi byte characters on big endian platforms
+            WriteBytes(data.data(), data.size() * sizeof(Char));
+          }
+
+          template <typename Range>
+          void SaveRange(const Range& range, std::size_t size)
+          {
+            WriteSize(size);
+
+            for (const auto& element : range)
+            {
+              Save(element);
+            }
+          }
+
+          template <typename T, typename Allocator>
+          void Save(const std::vector<T, Allocator>& data)
+          {
+            SaveVector(data, IsBulkSerializable<T>());
+          }
+
+          template <typename T, typename Allocator>
+          void SaveVector(const std::vector<T, Allocator>& data, std::true_type /*isBulk*/)
+          {
+            WriteSize(data.size());
+            WriteBytes(data.data(), data.size() * sizeof(T));
+          }
+
+          template <typename T, typename Allocator>
+          void SaveVector(const std::vector<T, Allocator>& data, std::false_type /*isBulk*/)
+          {
+            SaveRange(data, data.size());
+          }
+
+          template <typename Allocator>
+          void Save(const std::vector<bool, Allocator>& data)
+          {
+            WriteSize(data.size());
+
+            for (bool element : data)
+            {
+              SaveArithmetic(element);
+            }
+          }
+
+          template <typename T, typename Allocator>
+          void Save(const std::list<T, Allocator>& data)
+          {
+            SaveRange(data, data.size());
+          }
+
+          template <typename T, typename Allocator>
+          void Save(const std::deque<T, Allocator>& data)
+          {
+            SaveRange(data, data.size());
+          }
+
+          template <typename Key, typename Compare, typename Allocator>
+          void Save(const std::set<Key, Compare, Allocator>& data)
+          {
+            SaveRange(data, data.size());
+          }
+
+          template <typename Key, typename Compare, typename Allocator>
+          void Save(const std::multiset<Key, Compare, Allocator>& data)
+          {
+            SaveRange(data, data.size());
+          }
+
+          template <typename Key, typename Value, typename Compare, typename Allocator>
+          void Save(const std::map<Key, Value, Compare, Allocator>& data)
+          {
+            SaveRange(data, data.size());
+          }
+
+          template <typename Key, typename Value, typename Compare, typename Allocator>
+          void Save(const std::multimap<Key, Value, Compare, Allocator>& data)
+          {
+            SaveRange(data, data.size());
+          }
+
+          template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+          void Save(const std::unordered_set<Key, Hash, KeyEqual, Allocator>& data)
+          {
+            SaveRange(data, data.size());
+          }
+
+          template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+          void Save(const std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>& data)
+          {
+            SaveRange(data, data.size());
+          }
+
+          template <typename T, std::size_t Size>
+          void Save(const std::array<T, Size>& data)
+          {
+            // size is part of the type, no need to transfer it
+            SaveArray(data, IsBulkSerializable<T>());
+          }
+
+          template <typename T, std::size_t Size>
+          void SaveArray(const std::array<T, Size>& data, std::true_type /*isBulk*/)
+          {
+            WriteBytes(data.data(), Size * sizeof(T));
+          }
+
+          template <typename T, std::size_t Size>
+          void SaveArray(const std::array<T, Size>& data, std::false_type /*isBulk*/)
+          {
+            for (const auto& element : data)
+            {
+              Save(element);
+            }
+          }
+
+          template <typename First, typename Second>
+          void Save(const std::pair<First, Second>& data)
+          {
+            Save(data.first);
+            Save(data.second);
+          }
+
+          template <typename... Types>
+          void Save(const std::tuple<Types...>& data)
+          {
+            SaveTuple(data, std::index_sequence_for<Types...>());
+          }
+
+          template <typename Tuple, std::size_t... Indices>
+          void SaveTuple(const Tuple& data, std::index_sequence<Indices...>)
+          {
+            // use initializer list to guarantee left to right evaluation
+            const int dummy[] = {0, (Save(std::get<Indices>(data)), 0)...};
+            (void) dummy;
+          }
+
+          class VariantSaveVisitor : public boost::static_visitor<>
+          {
+            public:
+              explicit VariantSaveVisitor(BinaryOArchive& archive)
+              : m_Archive(archive)
+              {}
+
+              template <typename T>
+              void operator()(const T& data) const
+              {
+                m_Archive << data;
+              }
+
+            private:
+              BinaryOArchive& m_Archive;
+          };
+
+          template <typename... Types>
+          void Save(const boost::variant<Types...>& data)
+          {
+            WriteSize(static_cast<std::uint64_t>(data.which()));
+
+            boost::apply_visitor(VariantSaveVisitor(*this), data);
+          }
+      };  // class BinaryOArchive
+
+
+      class BinaryIArchive
+      {
+        public:
+          // required by boost::serialization::split_member / split_free
+          using is_saving  = boost::mpl::false_;
+          using is_loading = boost::mpl::true_;
+
+          // reads directly from data, no copy is made (data needs to outlive the archive)
+          explicit BinaryIArchive(BufferView data)
+          : m_Position(data.data()), m_End(data.data() + data.size())
+          {}
+
+          BinaryIArchive(const BinaryIArchive&) = delete;
+          BinaryIArchive& operator=(const BinaryIArchive&) = delete;
+
+          template <typename T>
+          BinaryIArchive& operator>>(T& data)
+          {
+            Load(data);
+            return *this;
+          }
+
+          template <typename T>
+          BinaryIArchive& operator&(T& data)
+          {
+            return *this >> data;
+          }
+
+          void ReadBytes(void* data, std::size_t size)
+          {
+            CheckAvailable(size);
+
+            if (size > 0)
+            {
+              std::memcpy(data, m_Position, size);
+              m_Position += size;
+            }
+          }
+
+          std::uint64_t ReadSize()
+          {
+            std::uint64_t size = 0;
+
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+              CheckAvailable(1);
+
+              const Byte byte = *m_Position++;
+
+              size |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+
+              if ((byte & 0x80) == 0)
+              {
+                return size;
+              }
+            }
+
+            throw ExceptionImpl<MalformedMessage>("Invalid size encoding in binary archive");
+          }
+
+          // like ReadSize() but checks that at least size * minElementSize bytes are left in the archive,
+          // protects against huge allocations triggered by corrupted messages
+          std::size_t ReadElementCount(std::size_t minElementSize)
+          {
+            const auto count = ReadSize();
+
+            if ((minElementSize > 0) && (count > static_cast<std::uint64_t>(GetRemainingSize() / minElementSize)))
+            {
+              throw ExceptionImpl<MalformedMessage>((boost::format("Element count %1% exceeds remaining data in binary archive") % count).str());
+            }
+
+            return static_cast<std::size_t>(count);
+          }
+
+          std::size_t GetRemainingSize() const
+          {
+            return static_cast<std::size_t>(m_End - m_Position);
+          }
+
+        private:
+          const Byte* m_Position;
+          const Byte* m_End;
+
+          void CheckAvailable(std::size_t size) const
+          {
+            if (size > GetRemainingSize())
+            {
+              throw ExceptionImpl<MalformedMessage>("Unexpected end of data in binary archive");
+            }
+          }
+
+          template <typename T>
+          void Load(T& data)
+          {
+            LoadHelper(data, std::integral_constant<bool, std::is_arithmetic<T>::value || std::is_enum<T>::value>());
+          }
+
+          // arithmetic types and enums
+          template <typename T>
+          void LoadHelper(T& data, std::true_type /*isArithmetic*/)
+          {
+            LoadArithmetic(data);
+          }
+
+          template <typename T>
+          void LoadHelper(T& data, std::false_type /*isArithmetic*/)
+          {
+            LoadObject(data, IsBitwiseObject<T>());
+          }
+
+          template <typename T>
+          void LoadObject(T& data, std::true_type /*isBitwise*/)
+          {
+            ReadBytes(&data, sizeof(data));
+          }
+
+          // user types, use boost::serialization
+          template <typename T>
+          void LoadObject(T& data, std::false_type /*isBitwise*/)
+          {
+            boost::serialization::serialize_adl(*this, data, boost::serialization::version<T>::value);
+          }
+
+          void LoadArithmetic(bool& data)
+          {
+            Byte byte;
+            ReadBytes(&byte, sizeof(byte));
+
+            if (byte > 1)
+            {
+              throw ExceptionImpl<MalformedMessage>("Invalid bool value in binary archive");
+            }
+
+            data = (byte != 0);
+          }
+
+          template <typename T>
+          void LoadArithmetic(T& data)
+          {
+#if BOOST_ENDIAN_LITTLE_BYTE
+            ReadBytes(&data, sizeof(data));
+#else
+            Byte bytes[sizeof(T)];
+            ReadBytes(bytes, sizeof(bytes));
+
+            Byte* destination = reinterpret_cast<Byte*>(&data);
+
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+            {
+              destination[i] = bytes[sizeof(T) - 1 - i];
+            }
+#endif
+          }
+
+          template <typename Char, typename Traits, typename Allocator>
+          void Load(std::basic_string<Char, Traits, Allocator>& data)
+          {
+            const auto size = ReadElementCount(sizeof(Char));
+
+            data.resize(size);
+
+            if (size > 0)
+            {
+              ReadBytes(&data[0], size * sizeof(Char));
+            }
+          }
+
+          template <typename T, typename Allocator>
+          void Load(std::vector<T, Allocator>& data)
+          {
+            LoadVector(data, IsBulkSerializable<T>());
+          }
+
+          template <typename T, typename Allocator>
+          void LoadVector(std::vector<T, Allocator>& data, std::true_type /*isBulk*/)
+          {
+            const auto size = ReadElementCount(sizeof(T));
+
+            data.resize(size);
+            ReadBytes(data.data(), size * sizeof(T));
+          }
+
+          template <typename T, typename Allocator>
+          void LoadVector(std::vector<T, Allocator>& data, std::false_type /*isBulk*/)
+          {
+            const auto size = ReadElementCount(1);
+
+            data.clear();
+            data.reserve(size);
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              data.emplace_back();
+              Load(data.back());
+            }
+          }
+
+          template <typename Allocator>
+          void Load(std::vector<bool, Allocator>& data)
+          {
+            const auto size = ReadElementCount(1);
+
+            data.resize(size);
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              bool element;
+              LoadArithmetic(element);
+              data[i] = element;
+            }
+          }
+
+          template <typename Sequence>
+          void LoadSequence(Sequence& data)
+          {
+            const auto size = ReadElementCount(1);
+
+            data.clear();
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              data.emplace_back();
+              Load(data.back());
+            }
+          }
+
+          template <typename T, typename Allocator>
+          void Load(std::list<T, Allocator>& data)
+          {
+            LoadSequence(data);
+          }
+
+          template <typename T, typename Allocator>
+          void Load(std::deque<T, Allocator>& data)
+          {
+            LoadSequence(data);
+          }
+
+          // temporary element using the allocator of its container (if it takes one), keeps elements of std::pmr containers in their arena
+          template <typename T, typename Allocator>
+          static T MakeElement(const Allocator& allocator)
+          {
+            return MakeElement<T>(allocator, std::integral_constant<bool, std::uses_allocator<T, Allocator>::value && std::is_constructible<T, const Allocator&>::value>());
+          }
+
+          template <typename T, typename Allocator>
+          static T MakeElement(const Allocator& allocator, std::true_type /*usesAllocator*/)
+          {
+            return T(allocator);
+          }
+
+          template <typename T, typename Allocator>
+          static T MakeElement(const Allocator& /*allocator*/, std::false_type /*usesAllocator*/)
+          {
+            return T();
+          }
+
+          template <typename Set>
+          void LoadSet(Set& data)
+          {
+            const auto size = ReadElementCount(1);
+
+            data.clear();
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              typename Set::value_type element = MakeElement<typename Set::value_type>(data.get_allocator());
+              Load(element);
+              data.insert(data.end(), std::move(element));
+            }
+          }
+
+          template <typename Key, typename Compare, typename Allocator>
+          void Load(std::set<Key, Compare, Allocator>& data)
+          {
+            LoadSet(data);
+          }
+
+          template <typename Key, typename Compare, typename Allocator>
+          void Load(std::multiset<Key, Compare, Allocator>& data)
+          {
+            LoadSet(data);
+          }
+
+          template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+          void Load(std::unordered_set<Key, Hash, KeyEqual, Allocator>& data)
+          {
+            LoadSet(data);
+          }
+
+          template <typename Map>
+          void LoadMap(Map& data)
+          {
+            const auto size = ReadElementCount(1);
+
+            data.clear();
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+              typename Map::key_type key = MakeElement<typename Map::key_type>(data.get_allocator());
+              Load(key);
+
+              // construct value in place, avoids copying (possibly large) values
+              auto iter = data.emplace_hint(data.end(), std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+              Load(iter->second);
+            }
+          }
+
+          template <typename Key, typename Value, typename Compare, typename Allocator>
+          void Load(std::map<Key, Value, Compare, Allocator>& data)
+          {
+            LoadMap(data);
+          }
+
+          template <typename Key, typename Value, typename Compare, typename Allocator>
+          void Load(std::multimap<Key, Value, Compare, Allocator>& data)
+          {
+            LoadMap(data);
+          }
+
+          template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+          void Load(std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>& data)
+          {
+            LoadMap(data);
+          }
+
+          template <typename T, std::size_t Size>
+          void Load(std::array<T, Size>& data)
+          {
+            LoadArray(data, IsBulkSerializable<T>());
+          }
+
+          template <typename T, std::size_t Size>
+          void LoadArray(std::array<T, Size>& data, std::true_type /*isBulk*/)
+          {
+            ReadBytes(data.data(), Size * sizeof(T));
+          }
+
+          template <typename T, std::size_t Size>
+          void LoadArray(std::array<T, Size>& data, std::false_type /*isBulk*/)
+          {
+            for (auto& element : data)
+            {
+              Load(element);
+            }
+          }
+
+          template <typename First, typename Second>
+          void Load(std::pair<First, Second>& data)
+          {
+            // key of map value_type is const
+            Load(const_cast<std::remove_const_t<First>&>(data.first));
+            Load(data.second);
+          }
+
+          template <typename... Types>
+          void Load(std::tuple<Types...>& data)
+          {
+            LoadTuple(data, std::index_sequence_for<Types...>());
+          }
+
+          template <typename Tuple, std::size_t... Indices>
+          void LoadTuple(Tuple& data, std::index_sequence<Indices...>)
+          {
+            // use initializer list to guarantee left to right evaluation
+            const int dummy[] = {0, (Load(std::get<Indices>(data)), 0)...};
+            (void) dummy;
+          }
+
+          template <typename Types, bool Empty = boost::mpl::empty<Types>::value>
+          struct VariantLoader
+          {
+            template <typename Variant>
+            static void Load(BinaryIArchive& archive, std::uint64_t which, Variant& data)
+            {
+              if (which == 0)
+              {
+                typename boost::mpl::front<Types>::type value;
+                archive >> value;
+                data = std::move(value);
+              }
+              else
+              {
+                VariantLoader<typename boost::mpl::pop_front<Types>::type>::Load(archive, which - 1, data);
+              }
+            }
+          };
+
+          // recursion sentinal, index was out of range
+          template <typename Types>
+          struct VariantLoader<Types, true>
+          {
+            template <typename Variant>
+            static void Load(BinaryIArchive& /*archive*/, std::uint64_t /*which*/, Variant& /*data*/)
+            {
+              throw ExceptionImpl<MalformedMessage>("Invalid variant index in binary archive");
+            }
+          };
+
+          template <typename... Types>
+          void Load(boost::variant<Types...>& data)
+          {
+            VariantLoader<typename boost::variant<Types...>::types>::Load(*this, ReadSize(), data);
+          }
+      };  // class BinaryIArchive
+
+    }  // namespace Detail
+
+
+    // compact little-endian binary encoding, writes directly into Buffer
+    struct BinarySerializer
+    {
+      using OArchive = Detail::BinaryOArchive;
+      using IArchive = Detail::BinaryIArchive;
+    };
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif
@@ -0,0 +1,194 @@
+#include "Buffer.h"
+
+#include <new>
+#include <array>
+
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    namespace Detail
+    {
+
+      namespace
+      {
+
+        const std::size_t MinBlockClassShift = 8;   // 256 bytes
+        const std::size_t MaxBlockClassShift = 16;  // 64 KiB
+        const std::size_t BlockClassCount = MaxBlockClassShift - MinBlockClassShift + 1;
+
+        const std::size_t MaxCachedBlocks = 64;              // per size class and thread
+        const std::size_t MaxCachedBytes = 256 * 1024;       // per size class and thread
+
+        // returns BlockClassCount for blocks not taken from the caches
+        std::size_t GetBlockClass(std::size_t capacity)
+        {
+          std::size_t blockClass = 0;
+
+          while ((blockClass < BlockClassCount) && (capacity > (std::size_t(1) << (blockClass + MinBlockClassShift))))
+          {
+            ++blockClass;
+          }
+
+          return blockClass;
+        }
+
+        std::size_t GetMaxCachedBlocks(std::size_t blockClass)
+        {
+          return std::min(MaxCachedBlocks, MaxCachedBytes >> (blockClass + MinBlockClassShift));
+        }
+
+        BufferBlock* NewBlock(std::size_t capacity)
+        {
+          BufferBlock* block = static_cast<BufferBlock*>(::operator new(sizeof(BufferBlock) + capacity));
+
+          block->m_Capacity = capacity;
+          block->m_Next = nullptr;
+
+          return block;
+        }
+
+        void DeleteBlock(BufferBlock* block)
+        {
+          ::operator delete(block);
+        }
+
+        // released blocks of the current thread, a block may be released by another thread than the one that allocated it
+        class BlockCache
+        {
+          public:
+            BlockCache()
+            {
+              m_Blocks.fill(nullptr);
+              m_Counts.fill(0);
+            }
+
+            ~BlockCache()
+            {
+              s_Destroyed = true;
+
+              for (BufferBlock* block : m_Blocks)
+              {
+                while (block != nullptr)
+                {
+                  BufferBlock* next = block->m_Next;
+
+                  DeleteBlock(block);
+
+                  block = next;
+                }
+              }
+            }
+
+            BufferBlock* Get(std::size_t blockClass)
+            {
+              BufferBlock* block = m_Blocks[blockClass];
+
+              if (block != nullptr)
+              {
+                m_Blocks[blockClass] = block->m_Next;
+                --m_Counts[blockClass];
+              }
+
+              return block;
+            }
+
+            bool Put(std::size_t blockClass, BufferBlock* block)
+            {
+              if (m_Counts[blockClass] >= GetMaxCachedBlocks(blockClass))
+              {
+                return false;
+              }
+
+              block->m_Next = m_Blocks[blockClass];
+              m_Blocks[blockClass] = block;
+              ++m_Counts[blockClass];
+
+              return true;
+            }
+
+            // nullptr while the thread is shutting down (buffers destroyed after the cache are freed directly)
+            static BlockCache* GetInstance()
+            {
+              if (s_Destroyed)
+              {
+                return nullptr;
+              }
+
+              static thread_local BlockCache cache;
+
+              return &cache;
+            }
+
+          private:
+            std::array<BufferBlock*, BlockClassCount> m_Blocks;
+            std::array<std::size_t, BlockClassCount>  m_Counts;
+
+            static thread_local bool s_Destroyed;  // trivially destructible, valid even after the cache was destroyed
+        };
+
+        thread_local bool BlockCache::s_Destroyed = false;
+
+      }  // anonymous namespace
+
+
+      BufferBlock* AllocateBufferBlock(std::size_t capacity)
+      {
+        const std::size_t blockClass = GetBlockClass(capacity);
+
+        BufferBlock* block = nullptr;
+
+        if (blockClass < BlockClassCount)
+        {
+          BlockCache* cache = BlockCache::GetInstance();
+
+          if (cache != nullptr)
+          {
+            block = cache->Get(blockClass);
+          }
+
+          if (block == nullptr)
+          {
+            block = NewBlock(std::size_t(1) << (blockClass + MinBlockClassShift));
+          }
+        }
+        else
+        {
+          block = NewBlock(capacity);
+        }
+
+        new (&block->m_References) std::atomic<std::size_t>(1);
+
+        return block;
+      }
+
+      void ReleaseBufferBlock(BufferBlock* block) noexcept
+      {
+        assert(block != nullptr);
+
+        if (block->m_References.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+          return;
+        }
+
+        const std::size_t blockClass = GetBlockClass(block->m_Capacity);
+
+        if (blockClass < BlockClassCount)
+        {
+          BlockCache* cache = BlockCache::GetInstance();
+
+          if ((cache != nullptr) && cache->Put(blockClass, block))
+          {
+            return;
+          }
+        }
+
+        DeleteBlock(block);
+      }
+
+    }  // namespace Detail
+
+  }  // namespace V1
+}  // namespace CppRpc
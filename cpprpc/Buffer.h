@@ -0,0 +1,543 @@
+#ifndef CPPRPC_BUFFER_H
+#define CPPRPC_BUFFER_H
+
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <iterator>
+#include <initializer_list>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    using Byte = std::uint8_t;
+
+    class Buffer;
+
+    namespace Detail
+    {
+
+      // heap storage of a Buffer, the data follows the header, shared with slices (see BufferSlice)
+      struct BufferBlock
+      {
+        std::atomic<std::size_t> m_References;
+        std::size_t              m_Capacity;
+        BufferBlock*             m_Next;        // free list of a thread cache
+
+        Byte* GetData() { return reinterpret_cast<Byte*>(this + 1); }
+      };
+
+      // returns a block of at least capacity bytes with a single reference,
+      // blocks up to 64 KiB are taken from per thread caches of power of two size classes
+      BufferBlock* AllocateBufferBlock(std::size_t capacity);
+
+      // drops a reference, the last one hands the block to the cache of the current thread (or frees it)
+      void ReleaseBufferBlock(BufferBlock* block) noexcept;
+
+    }  // namespace Detail
+
+
+    // non-owning, read-only view of (a part of) a Buffer, the viewed data needs to outlive the view
+    class BufferView
+    {
+      public:
+        using value_type     = Byte;
+        using const_iterator = const Byte*;
+
+        BufferView()
+        : m_Data(nullptr), m_Size(0)
+        {}
+
+        BufferView(const Byte* data, std::size_t size)
+        : m_Data(data), m_Size(size)
+        {}
+
+        BufferView(const Buffer& buffer);
+
+        const Byte* data() const { return m_Data; }
+        std::size_t size() const { return m_Size; }
+        bool empty() const { return m_Size == 0; }
+
+        const_iterator begin() const { return m_Data; }
+        const_iterator end() const { return m_Data + m_Size; }
+
+        // view of the remaining data starting at offset
+        BufferView subview(std::size_t offset) const
+        {
+          assert(offset <= m_Size);
+
+          return BufferView(m_Data + offset, m_Size - offset);
+        }
+
+      private:
+        const Byte* m_Data;
+        std::size_t m_Size;
+    };
+
+
+    // ref-counted, read-only part of a Buffer, shares the data with the buffer (and other slices) instead of copying it
+    class BufferSlice
+    {
+      public:
+        BufferSlice() noexcept
+        : m_Block(nullptr), m_Data(nullptr), m_Size(0)
+        {}
+
+        BufferSlice(const BufferSlice& other) noexcept
+        : m_Block(other.m_Block), m_Data(other.m_Data), m_Size(other.m_Size)
+        {
+          if (m_Block != nullptr)
+          {
+            m_Block->m_References.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+
+        BufferSlice(BufferSlice&& other) noexcept
+        : m_Block(other.m_Block), m_Data(other.m_Data), m_Size(other.m_Size)
+        {
+          other.m_Block = nullptr;
+          other.m_Data = nullptr;
+          other.m_Size = 0;
+        }
+
+        ~BufferSlice()
+        {
+          if (m_Block != nullptr)
+          {
+            Detail::ReleaseBufferBlock(m_Block);
+          }
+        }
+
+        BufferSlice& operator=(BufferSlice other) noexcept
+        {
+          std::swap(m_Block, other.m_Block);
+          std::swap(m_Data, other.m_Data);
+          std::swap(m_Size, other.m_Size);
+
+          return *this;
+        }
+
+        const Byte* data() const { return m_Data; }
+        std::size_t size() const { return m_Size; }
+        bool empty() const { return m_Size == 0; }
+
+        const Byte* begin() const { return m_Data; }
+        const Byte* end() const { return m_Data + m_Size; }
+
+        operator BufferView() const { return BufferView(m_Data, m_Size); }
+
+      private:
+        friend class Buffer;
+
+        // takes over a reference of block
+        BufferSlice(Detail::BufferBlock* block, const Byte* data, std::size_t size) noexcept
+        : m_Block(block), m_Data(data), m_Size(size)
+        {}
+
+        Detail::BufferBlock* m_Block;
+        const Byte*          m_Data;
+        std::size_t          m_Size;
+    };
+
+
+    // contiguous byte buffer with the interface of std::vector<Byte> (as far as used by the library)
+    //
+    // small messages are stored inline, bigger ones in blocks taken from per thread size class caches (see Detail::AllocateBufferBlock()),
+    // neither needs a heap allocation in steady state; moving a buffer moves the inline data, views into it do not survive a move
+    class Buffer
+    {
+      public:
+        using value_type      = Byte;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = Byte&;
+        using const_reference = const Byte&;
+        using pointer         = Byte*;
+        using const_pointer   = const Byte*;
+        using iterator        = Byte*;
+        using const_iterator  = const Byte*;
+
+        // big enough for calls and results of small signatures
+        static const size_type InlineCapacity = 96;
+
+        Buffer() noexcept
+        : m_Data(m_Inline), m_Size(0), m_Capacity(InlineCapacity), m_Block(nullptr)
+        {}
+
+        explicit Buffer(size_type size, Byte value = 0)
+        : Buffer()
+        {
+          assign(size, value);
+        }
+
+        template <typename Iterator, typename = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+        Buffer(Iterator first, Iterator last)
+        : Buffer()
+        {
+          assign(first, last);
+        }
+
+        Buffer(std::initializer_list<Byte> data)
+        : Buffer()
+        {
+          assign(data.begin(), data.end());
+        }
+
+        Buffer(const Buffer& other)
+        : Buffer()
+        {
+          assign(other.begin(), other.end());
+        }
+
+        Buffer(Buffer&& other) noexcept
+        : Buffer()
+        {
+          MoveFrom(other);
+        }
+
+        ~Buffer()
+        {
+          if (m_Block != nullptr)
+          {
+            Detail::ReleaseBufferBlock(m_Block);
+          }
+        }
+
+        Buffer& operator=(const Buffer& other)
+        {
+          if (this != &other)
+          {
+            assign(other.begin(), other.end());
+          }
+
+          return *this;
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept
+        {
+          if (this != &other)
+          {
+            Free();
+            MoveFrom(other);
+          }
+
+          return *this;
+        }
+
+        Buffer& operator=(std::initializer_list<Byte> data)
+        {
+          assign(data.begin(), data.end());
+
+          return *this;
+        }
+
+        Byte* data() { return m_Data; }
+        const Byte* data() const { return m_Data; }
+
+        size_type size() const { return m_Size; }
+        size_type capacity() const { return m_Capacity; }
+        bool empty() const { return m_Size == 0; }
+
+        iterator begin() { return m_Data; }
+        iterator end() { return m_Data + m_Size; }
+        const_iterator begin() const { return m_Data; }
+        const_iterator end() const { return m_Data + m_Size; }
+        const_iterator cbegin() const { return m_Data; }
+        const_iterator cend() const { return m_Data + m_Size; }
+
+        Byte& operator[](size_type index) { assert(index < m_Size); return m_Data[index]; }
+        const Byte& operator[](size_type index) const { assert(index < m_Size); return m_Data[index]; }
+
+        Byte& front() { assert(!empty()); return m_Data[0]; }
+        const Byte& front() const { assert(!empty()); return m_Data[0]; }
+        Byte& back() { assert(!empty()); return m_Data[m_Size - 1]; }
+        const Byte& back() const { assert(!empty()); return m_Data[m_Size - 1]; }
+
+        // NOTE: modifications (except writing through data() or operator[]) detach the buffer from its slices, see Slice()
+
+        void clear() noexcept
+        {
+          if (IsShared())
+          {
+            // content is dropped anyway, no need to copy it
+            Free();
+          }
+
+          m_Size = 0;
+        }
+
+        void reserve(size_type capacity)
+        {
+          if (capacity > m_Capacity)
+          {
+            Reallocate(capacity);
+          }
+        }
+
+        void resize(size_type size)
+        {
+          resize(size, 0);
+        }
+
+        void resize(size_type size, Byte value)
+        {
+          Prepare(size);
+
+          if (size > m_Size)
+          {
+            std::memset(m_Data + m_Size, value, size - m_Size);
+          }
+
+          m_Size = size;
+        }
+
+        void push_back(Byte value)
+        {
+          Prepare(m_Size + 1);
+
+          m_Data[m_Size++] = value;
+        }
+
+        void pop_back()
+        {
+          assert(!empty());
+
+          --m_Size;
+        }
+
+        void assign(size_type size, Byte value)
+        {
+          m_Size = 0;
+
+          resize(size, value);
+        }
+
+        template <typename Iterator, typename = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+        void assign(Iterator first, Iterator last)
+        {
+          const size_type size = static_cast<size_type>(std::distance(first, last));
+
+          // source might be part of this buffer
+          if (Overlaps(first, size))
+          {
+            Buffer copy(first, last);
+
+            swap(copy);
+
+            return;
+          }
+
+          m_Size = 0;
+
+          Prepare(size);
+
+          std::copy(first, last, m_Data);
+
+          m_Size = size;
+        }
+
+        template <typename Iterator, typename = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+        iterator insert(const_iterator position, Iterator first, Iterator last)
+        {
+          const size_type offset = static_cast<size_type>(position - m_Data);
+          const size_type size = static_cast<size_type>(std::distance(first, last));
+
+          assert(offset <= m_Size);
+
+          if (Overlaps(first, size))
+          {
+            const Buffer copy(first, last);
+
+            return insert(m_Data + offset, copy.begin(), copy.end());
+          }
+
+          Prepare(m_Size + size);
+
+          std::memmove(m_Data + offset + size, m_Data + offset, m_Size - offset);
+          std::copy(first, last, m_Data + offset);
+
+          m_Size += size;
+
+          return m_Data + offset;
+        }
+
+        iterator insert(const_iterator position, size_type count, Byte value)
+        {
+          const size_type offset = static_cast<size_type>(position - m_Data);
+
+          assert(offset <= m_Size);
+
+          Prepare(m_Size + count);
+
+          std::memmove(m_Data + offset + count, m_Data + offset, m_Size - offset);
+          std::memset(m_Data + offset, value, count);
+
+          m_Size += count;
+
+          return m_Data + offset;
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+          const size_type offset = static_cast<size_type>(first - m_Data);
+          const size_type count = static_cast<size_type>(last - first);
+
+          assert(offset + count <= m_Size);
+
+          Prepare(m_Size);
+
+          std::memmove(m_Data + offset, m_Data + offset + count, m_Size - offset - count);
+
+          m_Size -= count;
+
+          return m_Data + offset;
+        }
+
+        void swap(Buffer& other) noexcept
+        {
+          Buffer temporary(std::move(other));
+
+          other = std::move(*this);
+          *this = std::move(temporary);
+        }
+
+        // shares size bytes starting at offset without copying them (inline data is copied into a block first),
+        // the slice keeps its data even if the buffer is modified or destroyed later on
+        BufferSlice Slice(size_type offset, size_type size)
+        {
+          assert(offset + size <= m_Size);
+
+          if (m_Block == nullptr)
+          {
+            Reallocate(std::max(m_Size, InlineCapacity + 1));
+          }
+
+          m_Block->m_References.fetch_add(1, std::memory_order_relaxed);
+
+          return BufferSlice(m_Block, m_Data + offset, size);
+        }
+
+        friend bool operator==(const Buffer& left, const Buffer& right)
+        {
+          return (left.m_Size == right.m_Size) && ((left.m_Size == 0) || (std::memcmp(left.m_Data, right.m_Data, left.m_Size) == 0));
+        }
+
+        friend bool operator!=(const Buffer& left, const Buffer& right)
+        {
+          return !(left == right);
+        }
+
+      private:
+        Byte*                m_Data;      // m_Inline or the data of m_Block
+        size_type            m_Size;
+        size_type            m_Capacity;
+        Detail::BufferBlock* m_Block;     // nullptr while inline
+        Byte                 m_Inline[InlineCapacity];
+
+        bool IsShared() const
+        {
+          return (m_Block != nullptr) && (m_Block->m_References.load(std::memory_order_acquire) > 1);
+        }
+
+        template <typename Iterator>
+        bool Overlaps(Iterator, size_type) const
+        {
+          return false;
+        }
+
+        bool Overlaps(const Byte* data, size_type size) const
+        {
+          return (size > 0) && (data < m_Data + m_Capacity) && (data + size > m_Data);
+        }
+
+        bool Overlaps(Byte* data, size_type size) const
+        {
+          return Overlaps(const_cast<const Byte*>(data), size);
+        }
+
+        // makes sure there is room for size bytes and the data is not shared with slices
+        void Prepare(size_type size)
+        {
+          if ((size > m_Capacity) || IsShared())
+          {
+            Reallocate(std::max(size, (m_Capacity < size) ? 2 * m_Capacity : m_Capacity));
+          }
+        }
+
+        void Reallocate(size_type capacity)
+        {
+          Detail::BufferBlock* block = Detail::AllocateBufferBlock(capacity);
+
+          if (m_Size > 0)
+          {
+            std::memcpy(block->GetData(), m_Data, m_Size);
+          }
+
+          if (m_Block != nullptr)
+          {
+            Detail::ReleaseBufferBlock(m_Block);
+          }
+
+          m_Block = block;
+          m_Data = block->GetData();
+          m_Capacity = block->m_Capacity;
+        }
+
+        // back to (empty) inline storage
+        void Free() noexcept
+        {
+          if (m_Block != nullptr)
+          {
+            Detail::ReleaseBufferBlock(m_Block);
+
+            m_Block = nullptr;
+          }
+
+          m_Data = m_Inline;
+          m_Size = 0;
+          m_Capacity = InlineCapacity;
+        }
+
+        // takes the data of other (which is empty afterwards), this is empty and inline
+        void MoveFrom(Buffer& other) noexcept
+        {
+          assert((m_Block == nullptr) && (m_Size == 0));
+
+          if (other.m_Block != nullptr)
+          {
+            m_Block = other.m_Block;
+            m_Data = other.m_Data;
+            m_Capacity = other.m_Capacity;
+
+            other.m_Block = nullptr;
+            other.m_Data = other.m_Inline;
+            other.m_Capacity = InlineCapacity;
+          }
+          else if (other.m_Size > 0)
+          {
+            std::memcpy(m_Inline, other.m_Inline, other.m_Size);
+          }
+
+          m_Size = other.m_Size;
+          other.m_Size = 0;
+        }
+    };
+
+
+    inline BufferView::BufferView(const Buffer& buffer)
+    : m_Data(buffer.data()), m_Size(buffer.size())
+    {}
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif
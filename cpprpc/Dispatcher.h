@@ -6,17 +6,29 @@
 #include <string>
 #include <functional>
 #include <map>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 #include <utility>
+#include <typeinfo>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
+#include <atomic>
 #include <memory>
+#include <future>
+#include <chrono>
+#include <stdexcept>
+#include <cstdint>
 
 #include <boost/format.hpp>
 #include <boost/noncopyable.hpp>
 
 #include "cpprpc/Types.h"
+#include "cpprpc/Exception.h"
 #include "cpprpc/Transport.h"
+#include "cpprpc/Marshaller.h"
+#include "cpprpc/Rcu.h"
+#include "cpprpc/ThreadPool.h"
 
 namespace CppRpc
 {
@@ -25,53 +37,111 @@ namespace CppRpc
     template <InterfaceMode Mode, template <InterfaceMode> class Dispatcher>
     class Interface;
 
-    namespace Detail
+    // how a server side dispatcher executes the calls received by its transports
+    enum class ServerMode
     {
-      
-      struct RemoteFunctionCall
-      {
-        RemoteFunctionCall()
-        {}
-
-        template <InterfaceMode Mode, template <InterfaceMode> class Dispatcher>
-        RemoteFunctionCall(const Interface<Mode, Dispatcher>& interface, const Name& functionName, const Buffer& paramData)
-        : m_InterfaceName(interface.GetName()), m_InterfaceVersion(interface.GetVersion()), m_FunctionName(functionName), m_ParameterData(paramData)
-        {
-        }
-
-        RemoteFunctionCall(RemoteFunctionCall&&) = default;
-        RemoteFunctionCall& operator=(RemoteFunctionCall&&) = default;
-
-        Name    m_InterfaceName;
-        Version m_InterfaceVersion;
-        Name    m_FunctionName;
-        Buffer  m_ParameterData;
-      };
-    }
-
+      Shared,       // all I/O threads (and worker threads, if any) share one function table
+      ShardPerCore  // every transport is a shard: its I/O thread is pinned to a core of its own and executes all calls with a private copy
+                    // of the function table, nothing is shared between shards on the call path
+    };
 
     // TODO: probably seperate Client and Server implmentation like with class Function (using FunctionImpl)
     template <InterfaceMode Mode>
     class Dispatcher : boost::noncopyable
     {
       public:
-        using RemoteFunctionCall = Detail::RemoteFunctionCall;
+        // de-serializes the parameters and appends the serialized result to the second argument
+        using FunctionImplementation = std::function<void(BufferView, Buffer&)>;
+
+        // same as FunctionImplementation, called directly without type erasure (see StaticInterface)
+        using StaticFunctionImplementation = void (*)(BufferView, Buffer&);
 
-        using FunctionImplementation = std::function<Buffer(const Buffer&)>;
+        // called with the result of a remote function call on the receive thread, must not block
+        using ResultHandler = std::function<void(Detail::ResultMessage)>;
 
-        Dispatcher(Transport<Mode>& transport);
+        // server side function calls are executed on a pool of workerThreadCount threads,
+        // or directly on the server thread (one call at a time) if workerThreadCount is 0 (required for ServerMode::ShardPerCore,
+        // throws std::invalid_argument otherwise)
+        explicit Dispatcher(Transport<Mode>& transport, std::size_t workerThreadCount = 0, ServerMode serverMode = ServerMode::Shared);
 
         ~Dispatcher();
 
-        void RegisterFunctionImplementation(const Interface<Mode, CppRpc::V1::Dispatcher>& interface, const Name& name, FunctionImplementation implementation);
+        // server side, serves further transports with the same registered functions (and worker threads), every transport gets an I/O thread
+        // of its own receiving all of its connections, a shard in ServerMode::ShardPerCore; the transport must stay alive until removed
+        // (or the dispatcher is destroyed)
+        void AddTransport(Transport<Mode>& transport);
+
+        // server side, returns after the I/O thread of transport stopped and all results of calls received from it were sent
+        void RemoveTransport(Transport<Mode>& transport);
+
+        // executionPolicy is used by servers with worker threads only
+        void RegisterFunctionImplementation(const Interface<Mode, CppRpc::V1::Dispatcher>& interface, const Name& name, FunctionImplementation implementation,
+                                            ExecutionPolicy executionPolicy = ExecutionPolicy::Offload);
+        void RegisterStaticFunctionImplementation(const Interface<Mode, CppRpc::V1::Dispatcher>& interface, const Name& name, StaticFunctionImplementation implementation,
+                                                  ExecutionPolicy executionPolicy = ExecutionPolicy::Offload);
         void DeregisterFunctionImplementation(const Interface<Mode, CppRpc::V1::Dispatcher>& interface, const Name& name);
 
-        Buffer CallRemoteFunction(const Buffer& callData);  // client side call into Transport
-        Buffer DoFunctionCall(const Buffer& callData);  // server side call into function implementation
+        // client side, empty buffer of the transport to serialize a call into (see Transport::Acquire())
+        Buffer AcquireBuffer() { return m_Transport.Acquire(); }
+
+        // client side call into Transport, any number of calls may be outstanding at the same time (from any thread)
+        Detail::ResultMessage CallRemoteFunction(Buffer callData);
+        void CallRemoteFunctionAsync(Buffer callData, ResultHandler resultHandler);
+        void CallRemoteFunctionOneWay(Buffer callData);  // returns as soon as the call was handed to the Transport
+
+        // server side call into function implementation, returns the result message (empty for one-way calls)
+        Buffer DoFunctionCall(BufferView callData);
+
+        // number of exceptions thrown by one-way functions (server side), these can not be reported to the caller
+        std::size_t GetOneWayExceptionCount() const { return m_OneWayExceptionCount; }
+
+        // number of results (server side) that could neither be sent nor be replaced by an error result, their callers never get an answer
+        std::size_t GetUnsentResultCount() const { return m_UnsentResultCount; }
+
+        // server side, called with a description of every error that can not be reported to a caller (e.g. an exception thrown by a one-way
+        // function), on the thread the error occurred on; exceptions thrown by it are ignored, nothing is reported if no handler is set (default)
+        using ErrorHandler = std::function<void(const std::string& description)>;
+
+        // returns after calls of the previous handler are done, must not be called from an error handler
+        void SetErrorHandler(ErrorHandler errorHandler);
+
+        // client side, queues all calls made by the current thread through the dispatcher and sends them as a single message
+        // when destroyed or flushed; synchronous calls flush the batch (incl. themselves) before waiting for their result
+        class Batch : boost::noncopyable
+        {
+          public:
+            explicit Batch(std::shared_ptr<Dispatcher> dispatcher);
+
+            ~Batch();
+
+            // sends all calls queued so far, fails them (and throws) if sending failed
+            void Flush();
+
+          private:
+            friend class Dispatcher;
+
+            std::shared_ptr<Dispatcher>        m_Dispatcher;
+            Batch*                             m_Previous;        // batches of one thread are nested
+            Buffer                             m_BatchData;
+            std::vector<Detail::CorrelationId> m_CorrelationIds;  // of the queued calls, one-way calls have none
+            bool                               m_HasCalls;
+
+            void Add(Detail::CorrelationId correlationId, BufferView callData);
+
+            static Batch*& GetCurrent()
+            {
+              thread_local Batch* current = nullptr;
+
+              return current;
+            }
+        };
 
       private:        
         
-        using Functions = std::map<Name, FunctionImplementation>;
+        using FunctionId = Detail::FunctionId;
+        using CorrelationId = Detail::CorrelationId;
+
+        using Functions = std::map<Name, FunctionId>;
 
         struct InterfaceIdentity
         {
@@ -86,8 +156,68 @@ namespace CppRpc
 
         using Interfaces = std::map<InterfaceIdentity, Functions>;
 
+        // ids are never removed nor reused, clients may have cached them, guarded by m_Mutex
         Interfaces m_Interfaces;
 
+        // not measured yet
+        static const std::uint64_t UnknownExecutionTime = ~std::uint64_t(0);
+
+        // calls of an adaptive function measured before its first decision
+        static const std::uint32_t AdaptiveSampleCount = 32;
+
+        // afterwards only one in this many calls of a thread is measured, the decision follows execution times changing over time
+        static const std::uint32_t AdaptiveResampleInterval = 64;
+
+        // execution time of an adaptive function, shared by all copies of the function table; after the first decision the calls between
+        // two samples do neither read the clock nor write shared data
+        struct ExecutionTime
+        {
+          ExecutionTime()
+          : m_Samples(0), m_Average(UnknownExecutionTime)
+          {}
+
+          std::atomic<std::uint32_t> m_Samples;
+          std::atomic<std::uint64_t> m_Average;  // in ns
+        };
+
+        // adaptive functions measured to be faster than this are executed inline, roughly the cost of a hand-off to a worker thread
+        static const std::uint64_t InlineExecutionTime = 2000;
+
+        struct RegisteredFunction
+        {
+          FunctionImplementation         m_Implementation;        // empty if the function is not registered (anymore) or static
+          StaticFunctionImplementation   m_StaticImplementation;  // nullptr if the function is not registered (anymore) or dynamic
+          ExecutionPolicy                m_ExecutionPolicy;
+          std::shared_ptr<ExecutionTime> m_ExecutionTime;         // adaptive functions of servers with worker threads only
+
+          bool IsRegistered() const
+          {
+            return (m_StaticImplementation != nullptr) || m_Implementation;
+          }
+
+          void Call(BufferView parameterData, Buffer& resultData) const
+          {
+            if (m_StaticImplementation != nullptr)
+            {
+              m_StaticImplementation(parameterData, resultData);
+            }
+            else
+            {
+              m_Implementation(parameterData, resultData);
+            }
+          }
+        };
+
+        // indexed by function id
+        using FunctionTable = std::vector<RegisteredFunction>;
+
+        using FunctionTablePointer = Detail::RcuPointer<FunctionTable>;
+
+        // read lock free on every call, copied and republished on (rare) de-/registration
+        FunctionTablePointer m_FunctionTable;
+
+        const ServerMode m_ServerMode;
+
         Transport<Mode>& m_Transport;  // TODO: change to shared_ptr
 
 
@@ -95,57 +225,304 @@ namespace CppRpc
         using Mutex  = std::recursive_mutex;
         using Lock   = std::unique_lock<Mutex>;
 
-        Thread m_ServerThread;
-        Mutex  m_Mutex;
+        Thread m_ReceiveThread;  // client side only
+        Mutex  m_Mutex;  // serializes de-/registration and function id resolution, not used on the call path
+
+        std::atomic<bool> m_StopReceiveThread;
+
+        // server side transport, received from by an I/O thread of its own
+        struct ServedTransport : boost::noncopyable
+        {
+          explicit ServedTransport(Transport<Mode>& transport)
+          : m_Transport(transport), m_Stop(false), m_SubmittedCalls(0), m_FunctionTable(), m_Core(0), m_Thread()
+          {}
+
+          Transport<Mode>&         m_Transport;
+          std::atomic<bool>        m_Stop;
+          std::atomic<std::size_t> m_SubmittedCalls;  // to the worker threads, results not sent yet
+
+          // shards only, private copy of m_FunctionTable (kept in sync by PublishFunctionTable()) and the core the I/O thread is pinned to
+          std::unique_ptr<FunctionTablePointer> m_FunctionTable;
+          std::size_t                           m_Core;
+
+          Thread m_Thread;
+        };
+
+        // counts a call submitted to the worker threads until its result was sent (or given up), see StopServing()
+        class SubmittedCall : boost::noncopyable
+        {
+          public:
+            explicit SubmittedCall(ServedTransport& transport)
+            : m_Transport(transport)
+            {}
+
+            ~SubmittedCall()
+            {
+              --m_Transport.m_SubmittedCalls;
+            }
+
+          private:
+            ServedTransport& m_Transport;
+        };
+
+        std::vector<std::unique_ptr<ServedTransport>> m_ServedTransports;
+        std::mutex                                    m_ServedTransportsMutex;  // taken after m_Mutex (if both)
+        std::size_t                                   m_NextCore;               // guarded by m_ServedTransportsMutex
+
+        std::unique_ptr<Detail::ThreadPool> m_WorkerThreads;  // nullptr if calls are executed on the server thread
+
+        std::atomic<std::size_t> m_OneWayExceptionCount;
+        std::atomic<std::size_t> m_UnsentResultCount;
+
+        Detail::RcuPointer<ErrorHandler> m_ErrorHandler;  // updates are serialized by m_Mutex
 
-        bool m_StopServerThread;
+        // client side calls waiting for their result, by correlation id
+        using PendingCalls = std::unordered_map<CorrelationId, ResultHandler>;
 
-        static void ServerThread(Dispatcher<Mode>* dispatcher);
+        PendingCalls               m_PendingCalls;
+        std::mutex                 m_PendingCallsMutex;
+        std::atomic<CorrelationId> m_NextCorrelationId;
+        bool                       m_ReceiveFailed;  // guarded by m_PendingCallsMutex, no further results are received, see FailPendingCalls()
+
+        // appends the result message to resultData, functions are looked up in functionTablePointer (m_FunctionTable or the copy of a shard);
+        // batches are not nested, a batch entry being a batch itself is rejected as malformed (bounds the recursion)
+        void DoFunctionCall(const FunctionTablePointer& functionTablePointer, BufferView callData, Buffer& resultData, bool batchEntry = false);
+
+        // never throws, exceptions are counted and reported, see SetErrorHandler()
+        void DoOneWayFunctionCall(const FunctionTablePointer& functionTablePointer, BufferView payload);
+
+        // passes description to the error handler (if any), never throws
+        void ReportError(const std::string& description);
+
+        // reports the exception currently handled (to be called from a catch block only), never throws
+        void ReportCurrentException(const char* context);
+
+        // calls the implementation, measures the execution time of adaptive functions
+        static void ExecuteFunction(const RegisteredFunction& function, BufferView parameterData, Buffer& resultData);
+
+        // exactly one of the implementations is set
+        void RegisterFunction(const Interface<Mode, CppRpc::V1::Dispatcher>& interface, const Name& name, FunctionImplementation implementation,
+                              StaticFunctionImplementation staticImplementation, ExecutionPolicy executionPolicy);
+
+        // server side with worker threads, true if the call (all calls of a batch) may be executed on the receiving thread, see ExecutionPolicy
+        static bool IsInlineCall(const FunctionTablePointer& functionTablePointer, BufferView callData, bool batchEntry = false);
+
+        // publishes functionTable, and a copy of it to every shard; m_Mutex must be held
+        void PublishFunctionTable(std::unique_ptr<FunctionTable> functionTable);
+
+        // innermost batch of the current thread for this dispatcher, nullptr if none
+        Batch* FindBatch();
+
+        void CompleteRemoteFunctionCall(Buffer&& resultData);
+        void CompleteRemoteFunctionCall(CorrelationId correlationId, Detail::ResultMessage&& resultMessage);
+        void FailRemoteFunctionCall(CorrelationId correlationId, const Detail::RemoteExceptionData& exceptionData);
+
+        // client side, fails all calls still waiting for their result, calls made afterwards throw TransportError
+        void FailPendingCalls(const Detail::RemoteExceptionData& exceptionData);
+
+        // sends the result message to connection, a result the transport refuses (e.g. exceeding its maximum message size) is replaced by an
+        // error result for the caller; never throws, results that can not be sent at all are counted and reported
+        void SendResult(Transport<Mode>& transport, ConnectionId connection, Buffer&& resultData);
+
+        // as SendResult(), falls back to sending the results one by one if the batch result is refused
+        void SendBatchResult(Transport<Mode>& transport, ConnectionId connection, const std::vector<Buffer>& results);
+
+        // server side execution on the worker threads, calls of a batch are executed in parallel, results are sent to connection of transport
+        void SubmitFunctionCall(ServedTransport& transport, ConnectionId connection, Buffer&& callData);
+
+        // stops the I/O thread, waits for the results of calls still executed by the worker threads
+        static void StopServing(ServedTransport& transport);
+
+        static Buffer MakeErrorResult(CorrelationId correlationId, const Detail::RemoteExceptionData& exceptionData);
+
+        static void ServerThread(Dispatcher<Mode>* dispatcher, ServedTransport* transport);
+        static void ClientThread(Dispatcher<Mode>* dispatcher);
     };  // class Dispatcher
 
 
     template <InterfaceMode Mode>
-    Dispatcher<Mode>::Dispatcher(Transport<Mode>& transport)
-    : m_Transport(transport), m_ServerThread(), m_Mutex(), m_StopServerThread(false)
+    Dispatcher<Mode>::Dispatcher(Transport<Mode>& transport, std::size_t workerThreadCount, ServerMode serverMode)
+    : m_Interfaces(), m_FunctionTable(std::unique_ptr<const FunctionTable>(new FunctionTable())), m_ServerMode(serverMode), m_Transport(transport), m_ReceiveThread(), m_Mutex(),
+      m_StopReceiveThread(false), m_ServedTransports(), m_ServedTransportsMutex(), m_NextCore(0), m_WorkerThreads(), m_OneWayExceptionCount(0), m_UnsentResultCount(0),
+      m_ErrorHandler(std::unique_ptr<const ErrorHandler>(new ErrorHandler())),
+      m_PendingCalls(), m_PendingCallsMutex(), m_NextCorrelationId(Detail::NoCorrelationId + 1), m_ReceiveFailed(false)
     {
 #pragma warning(suppress: 4127)  // conditional expression is constant
       if (Mode == InterfaceMode::Server)
       {
-        m_ServerThread = Thread(ServerThread, this);
+        // shards execute calls themselves
+        if ((workerThreadCount > 0) && (serverMode == ServerMode::ShardPerCore))
+        {
+          throw std::invalid_argument("ServerMode::ShardPerCore requires workerThreadCount 0");
+        }
+
+        if (workerThreadCount > 0)
+        {
+          m_WorkerThreads.reset(new Detail::ThreadPool(workerThreadCount));
+        }
+
+        AddTransport(transport);
+      }
+      else
+      {
+        m_ReceiveThread = Thread(ClientThread, this);
       }
     }
 
     template <InterfaceMode Mode>
     Dispatcher<Mode>::~Dispatcher()
     {
+      m_StopReceiveThread = true;
+
+      if (m_ReceiveThread.joinable())
+      {
+        // wakes up the receiving thread (transports without Interrupt() support wake it up with their receive timeout)
+        m_Transport.Interrupt();
+
+        m_ReceiveThread.join();
+      }
+
+      for (auto& servedTransport : m_ServedTransports)
+      {
+        StopServing(*servedTransport);
+      }
+
+      // finishes calls already received, function table must still be alive
+      m_WorkerThreads.reset();
+
+      FailPendingCalls({typeid(LocalException).name(), "Dispatcher destroyed while waiting for the result"});
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::AddTransport(Transport<Mode>& transport)
+    {
+#pragma warning(suppress: 4127)  // conditional expression is constant
+      assert(Mode == InterfaceMode::Server);
+
+      std::unique_ptr<ServedTransport> servedTransport(new ServedTransport(transport));
+
+      // no de-/registration while the copy of a shard is made
+      Lock lock(m_Mutex);
+
+      std::lock_guard<std::mutex> servedTransportsLock(m_ServedTransportsMutex);
+
+      if (m_ServerMode == ServerMode::ShardPerCore)
+      {
+        servedTransport->m_FunctionTable.reset(new FunctionTablePointer(std::unique_ptr<const FunctionTable>(new FunctionTable(*m_FunctionTable.Read()))));
+        servedTransport->m_Core = m_NextCore++;
+      }
+
+      m_ServedTransports.reserve(m_ServedTransports.size() + 1);
+
+      servedTransport->m_Thread = Thread(ServerThread, this, servedTransport.get());
+
+      m_ServedTransports.push_back(std::move(servedTransport));
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::RemoveTransport(Transport<Mode>& transport)
+    {
+#pragma warning(suppress: 4127)  // conditional expression is constant
+      assert(Mode == InterfaceMode::Server);
+
+      std::unique_ptr<ServedTransport> servedTransport;
+
       {
-        Lock lock(m_Mutex);
+        std::lock_guard<std::mutex> lock(m_ServedTransportsMutex);
 
-        m_StopServerThread = true;
+        auto servedTransportIter = std::find_if(m_ServedTransports.begin(), m_ServedTransports.end(),
+                                                [&transport] (const std::unique_ptr<ServedTransport>& served) { return &served->m_Transport == &transport; });
+
+        if (servedTransportIter == m_ServedTransports.end())
+        {
+          throw Detail::ExceptionImpl<UnknownTransport>("Transport is not served by this dispatcher");
+        }
+
+        servedTransport = std::move(*servedTransportIter);
+
+        m_ServedTransports.erase(servedTransportIter);
       }
 
-      if (m_ServerThread.joinable())
+      // not while holding the lock, the I/O thread may be in the middle of a call
+      StopServing(*servedTransport);
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::StopServing(ServedTransport& transport)
+    {
+      transport.m_Stop = true;
+
+      // wakes up the I/O thread (transports without Interrupt() support wake it up with their receive timeout)
+      transport.m_Transport.Interrupt();
+
+      transport.m_Thread.join();
+
+      while (transport.m_SubmittedCalls > 0)
       {
-        m_ServerThread.join();
+        std::this_thread::yield();
       }
     }
 
     template <InterfaceMode Mode>
-    void Dispatcher<Mode>::RegisterFunctionImplementation(const Interface<Mode, CppRpc::V1::Dispatcher>& interface, const Name& name, FunctionImplementation implementation)
+    void Dispatcher<Mode>::RegisterFunctionImplementation(const Interface<Mode, CppRpc::V1::Dispatcher>& interface, const Name& name, FunctionImplementation implementation,
+                                                          ExecutionPolicy executionPolicy)
+    {
+      assert(implementation);
+
+      RegisterFunction(interface, name, std::move(implementation), nullptr, executionPolicy);
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::RegisterStaticFunctionImplementation(const Interface<Mode, CppRpc::V1::Dispatcher>& interface, const Name& name, StaticFunctionImplementation implementation,
+                                                                ExecutionPolicy executionPolicy)
+    {
+      assert(implementation != nullptr);
+
+      RegisterFunction(interface, name, FunctionImplementation(), implementation, executionPolicy);
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::RegisterFunction(const Interface<Mode, CppRpc::V1::Dispatcher>& interface, const Name& name, FunctionImplementation implementation,
+                                            StaticFunctionImplementation staticImplementation, ExecutionPolicy executionPolicy)
     {
       InterfaceIdentity interfaceIdentity = {interface.GetName(), interface.GetVersion()};
 
       Lock lock(m_Mutex);
 
       // insert interface or find interface in map
-      auto result = m_Interfaces.emplace(interfaceIdentity, Functions());
+      Functions& functions = m_Interfaces[interfaceIdentity];
+
+      // copy current function table, readers keep using the current one meanwhile
+      std::unique_ptr<FunctionTable> functionTable(new FunctionTable(*m_FunctionTable.Read()));
+
+      // assign new id to unknown functions
+      auto functionIter = functions.find(name);
 
+      if (functionIter == functions.end())
+      {
+        functionIter = functions.emplace(name, static_cast<FunctionId>(functionTable->size())).first;
+        functionTable->emplace_back();
+      }
+
+      RegisteredFunction& function = (*functionTable)[functionIter->second];
 
       // where we able to insert the new function or did it already exist?
-      if (!result.first->second.emplace(name, implementation).second)
+      if (function.IsRegistered())
       {
         throw Detail::ExceptionImpl<FunctionAlreadyRegistred>((boost::format("Function \"%1%:%2%::%3%\" already registerd") % interface.GetName() % interface.GetVersion().str() % name).str());
       }
+
+      function.m_Implementation = std::move(implementation);
+      function.m_StaticImplementation = staticImplementation;
+      function.m_ExecutionPolicy = executionPolicy;
+
+      // without worker threads all calls are executed inline anyway, nothing to measure
+      if ((executionPolicy == ExecutionPolicy::Adaptive) && m_WorkerThreads)
+      {
+        function.m_ExecutionTime = std::make_shared<ExecutionTime>();
+      }
+
+      PublishFunctionTable(std::move(functionTable));
     }
 
     template <InterfaceMode Mode>
@@ -164,93 +541,1017 @@ namespace CppRpc
       // find function
       auto functionIter = interfaceIter->second.find(name);
 
-      if (functionIter == interfaceIter->second.end())
+      if ((functionIter == interfaceIter->second.end()) || !(*m_FunctionTable.Read())[functionIter->second].IsRegistered())
       {
         throw Detail::ExceptionImpl<UnknownFunction>((boost::format("Unknown Function \"%1%:%2%::%3%\"") % interface.GetName() % interface.GetVersion().str() % name).str());
       }
 
-      // remove function
-      interfaceIter->second.erase(functionIter);
+      // remove function, keep its id
+      std::unique_ptr<FunctionTable> functionTable(new FunctionTable(*m_FunctionTable.Read()));
+
+      (*functionTable)[functionIter->second] = RegisteredFunction();
+
+      // returns after all running calls (which might still use the removed function) are done
+      PublishFunctionTable(std::move(functionTable));
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::SetErrorHandler(ErrorHandler errorHandler)
+    {
+      Lock lock(m_Mutex);
+
+      m_ErrorHandler.Update(std::unique_ptr<const ErrorHandler>(new ErrorHandler(std::move(errorHandler))));
+    }
 
-      // remove Interface if empty
-      if (interfaceIter->second.empty())
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::PublishFunctionTable(std::unique_ptr<FunctionTable> functionTable)
+    {
       {
-        m_Interfaces.erase(interfaceIter);
+        std::lock_guard<std::mutex> lock(m_ServedTransportsMutex);
+
+        for (auto& servedTransport : m_ServedTransports)
+        {
+          if (servedTransport->m_FunctionTable)
+          {
+            servedTransport->m_FunctionTable->Update(std::unique_ptr<const FunctionTable>(new FunctionTable(*functionTable)));
+          }
+        }
       }
+
+      m_FunctionTable.Update(std::move(functionTable));
     }
 
     template <InterfaceMode Mode>
-    Buffer Dispatcher<Mode>::CallRemoteFunction(const Buffer& callData)
+    Detail::ResultMessage Dispatcher<Mode>::CallRemoteFunction(Buffer callData)
     {
-      m_Transport.Send(callData);
+      std::promise<Detail::ResultMessage> result;
+
+      std::future<Detail::ResultMessage> futureResult = result.get_future();
 
-      Buffer returnData;
+      CallRemoteFunctionAsync(std::move(callData), [&result] (Detail::ResultMessage resultMessage) { result.set_value(std::move(resultMessage)); });
+
+      // do not wait for a call that was only queued
+      if (Batch* batch = FindBatch())
+      {
+        batch->Flush();
+      }
 
       // TODO: handle timeouts and stuff ...
-      while (!m_Transport.Receive(returnData));
-      
-      return returnData;      
+      return futureResult.get();
     }
 
     template <InterfaceMode Mode>
-    Buffer Dispatcher<Mode>::DoFunctionCall(const Buffer& callData)
+    void Dispatcher<Mode>::CallRemoteFunctionAsync(Buffer callData, ResultHandler resultHandler)
     {
-      Detail::RemoteFunctionCall functionHeader = Marshaller<CppRpc::V1::Dispatcher>::DeserializeFunctionDispatchHeader(callData);
-
-      FunctionImplementation functionImpl;
+      // skip NoCorrelationId on wrap around, ids of calls outstanding for that long are not expected to collide
+      CorrelationId correlationId;
 
+      do
       {
-        Lock lock(m_Mutex);
+        correlationId = m_NextCorrelationId++;
+      } while (correlationId == Detail::NoCorrelationId);
 
-        auto interfaceIter = m_Interfaces.find({functionHeader.m_InterfaceName, functionHeader.m_InterfaceVersion});
+      DefaultMarshaller<CppRpc::V1::Dispatcher>::SetCorrelationId(callData, correlationId);
 
-        if (interfaceIter != m_Interfaces.end())
-        {
-          auto functionIter = interfaceIter->second.find(functionHeader.m_FunctionName);
+      // register before sending, the result may arrive before Send() returns
+      {
+        std::lock_guard<std::mutex> lock(m_PendingCallsMutex);
 
-          if (functionIter != interfaceIter->second.end())
-          {
-            // found function implementation
-            functionImpl = functionIter->second;
-          }
-          else
-          {
-            // TODO: throw error
-            return Buffer();
-          }
-        }
-        else
+        if (m_ReceiveFailed)
         {
-          // TODO: thorw error
-          return Buffer();
+          throw Detail::ExceptionImpl<TransportError>("Unable to receive results, connection lost");
         }
+
+        m_PendingCalls.emplace(correlationId, std::move(resultHandler));
+      }
+
+      if (Batch* batch = FindBatch())
+      {
+        batch->Add(correlationId, callData);
+
+        return;
+      }
+
+      try
+      {
+        m_Transport.Commit(std::move(callData));
       }
 
-      assert(functionImpl);
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(m_PendingCallsMutex);
+
+        m_PendingCalls.erase(correlationId);
 
-      // call function implementation
-      return functionImpl(functionHeader.m_ParameterData);
+        throw;
+      }
     }
 
     template <InterfaceMode Mode>
-    void Dispatcher<Mode>::ServerThread(Dispatcher<Mode>* dispatcher)
+    void Dispatcher<Mode>::CallRemoteFunctionOneWay(Buffer callData)
     {
-      assert(dispatcher != nullptr);
+      // not correlated to any result
+      if (Batch* batch = FindBatch())
+      {
+        batch->Add(Detail::NoCorrelationId, callData);
 
-      Buffer callData;
+        return;
+      }
 
-      for (;;)
-      {        
-        if (dispatcher->m_Transport.Receive(callData))  // non-blocking, timeout mandatory in Transport::Receive() !
+      m_Transport.Commit(std::move(callData));
+    }
+
+    template <InterfaceMode Mode>
+    typename Dispatcher<Mode>::Batch* Dispatcher<Mode>::FindBatch()
+    {
+      for (Batch* batch = Batch::GetCurrent(); batch != nullptr; batch = batch->m_Previous)
+      {
+        if (batch->m_Dispatcher.get() == this)
         {
-          assert(callData.size() >= sizeof(Detail::RemoteFunctionCall));
+          return batch;
+        }
+      }
+
+      return nullptr;
+    }
+
+    template <InterfaceMode Mode>
+    Dispatcher<Mode>::Batch::Batch(std::shared_ptr<Dispatcher> dispatcher)
+    : m_Dispatcher(std::move(dispatcher)), m_Previous(GetCurrent()), m_BatchData(), m_CorrelationIds(), m_HasCalls(false)
+    {
+      static_assert(Mode == InterfaceMode::Client, "batches are only supported in client mode");
+
+      assert(m_Dispatcher);
+
+      GetCurrent() = this;
+    }
+
+    template <InterfaceMode Mode>
+    Dispatcher<Mode>::Batch::~Batch()
+    {
+      assert(GetCurrent() == this);
+
+      GetCurrent() = m_Previous;
+
+      try
+      {
+        Flush();
+      }
+
+      catch (...)
+      {
+        // queued calls already failed
+        // TODO: add trace / logging
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::Batch::Add(CorrelationId correlationId, BufferView callData)
+    {
+      if (m_BatchData.empty())
+      {
+        DefaultMarshaller<CppRpc::V1::Dispatcher>::SerializeBatchHeader(m_BatchData, Detail::MessageType::Batch);
+      }
+
+      DefaultMarshaller<CppRpc::V1::Dispatcher>::AppendBatchMessage(m_BatchData, callData);
+
+      if (correlationId != Detail::NoCorrelationId)
+      {
+        m_CorrelationIds.push_back(correlationId);
+      }
+
+      m_HasCalls = true;
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::Batch::Flush()
+    {
+      if (!m_HasCalls)
+      {
+        return;
+      }
+
+      Buffer batchData;
+      std::vector<CorrelationId> correlationIds;
+
+      m_HasCalls = false;
+
+      // start a new batch, calls may be added again while this one is sent
+      batchData.swap(m_BatchData);
+      correlationIds.swap(m_CorrelationIds);
 
-          dispatcher->m_Transport.Send(dispatcher->DoFunctionCall(callData));
+      try
+      {
+        m_Dispatcher->m_Transport.Send(std::move(batchData));
+      }
+
+      catch (const std::exception& e)
+      {
+        // callers already returned, report the error through their result handlers
+        for (CorrelationId correlationId : correlationIds)
+        {
+          m_Dispatcher->FailRemoteFunctionCall(correlationId, {typeid(e).name(), e.what()});
         }
 
-        Lock lock(dispatcher->m_Mutex);
+        throw;
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::CompleteRemoteFunctionCall(Buffer&& resultData)
+    {
+      Detail::MessageHeader header;
+
+      try
+      {
+        header = DefaultMarshaller<CppRpc::V1::Dispatcher>::DeserializeMessageHeader(resultData);
+      }
+
+      catch (const std::exception&)
+      {
+        // TODO: add trace / logging
+        return;
+      }
+
+      if (header.m_Type == Detail::MessageType::BatchResult)
+      {
+        // results share the batch data instead of copying it, see Detail::ResultMessage (inline data is moved to the heap first)
+        const BufferSlice batchData = resultData.Slice(0, resultData.size());
+
+        std::vector<BufferView> results;
+
+        try
+        {
+          results = DefaultMarshaller<CppRpc::V1::Dispatcher>::DeserializeBatch(BufferView(batchData).subview(Detail::MessageHeaderSize));
+        }
+
+        catch (const std::exception&)
+        {
+          // TODO: add trace / logging
+          return;
+        }
+
+        for (BufferView result : results)
+        {
+          Detail::MessageHeader resultHeader;
+
+          try
+          {
+            resultHeader = DefaultMarshaller<CppRpc::V1::Dispatcher>::DeserializeMessageHeader(result);
+          }
+
+          catch (const std::exception&)
+          {
+            // TODO: add trace / logging
+            continue;
+          }
+
+          if (resultHeader.m_Type != Detail::MessageType::Result)
+          {
+            // TODO: add trace / logging
+            continue;
+          }
+
+          CompleteRemoteFunctionCall(resultHeader.m_CorrelationId, {Buffer(), resultData.Slice(static_cast<std::size_t>(result.data() - batchData.data()), result.size())});
+        }
+
+        return;
+      }
+
+      if (header.m_Type != Detail::MessageType::Result)
+      {
+        // TODO: add trace / logging
+        return;
+      }
+
+      assert(header.m_Payload.data() == resultData.data() + Detail::MessageHeaderSize);
+
+      CompleteRemoteFunctionCall(header.m_CorrelationId, {std::move(resultData), BufferSlice()});
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::CompleteRemoteFunctionCall(CorrelationId correlationId, Detail::ResultMessage&& resultMessage)
+    {
+      ResultHandler resultHandler;
+
+      {
+        std::lock_guard<std::mutex> lock(m_PendingCallsMutex);
+
+        auto pendingCall = m_PendingCalls.find(correlationId);
+
+        if (pendingCall == m_PendingCalls.end())
+        {
+          // TODO: add trace / logging
+          return;
+        }
+
+        resultHandler = std::move(pendingCall->second);
+        m_PendingCalls.erase(pendingCall);
+      }
+
+      resultHandler(std::move(resultMessage));
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::FailRemoteFunctionCall(CorrelationId correlationId, const Detail::RemoteExceptionData& exceptionData)
+    {
+      CompleteRemoteFunctionCall(MakeErrorResult(correlationId, exceptionData));
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::FailPendingCalls(const Detail::RemoteExceptionData& exceptionData)
+    {
+      PendingCalls pendingCalls;
+
+      {
+        std::lock_guard<std::mutex> lock(m_PendingCallsMutex);
+
+        m_ReceiveFailed = true;
+
+        pendingCalls.swap(m_PendingCalls);
+      }
+
+      for (auto& pendingCall : pendingCalls)
+      {
+        try
+        {
+          pendingCall.second({MakeErrorResult(pendingCall.first, exceptionData), BufferSlice()});
+        }
+
+        catch (...)
+        {
+          // TODO: add trace / logging
+        }
+      }
+    }
+
+    template <InterfaceMode Mode>
+    Buffer Dispatcher<Mode>::MakeErrorResult(CorrelationId correlationId, const Detail::RemoteExceptionData& exceptionData)
+    {
+      using Marshaller = DefaultMarshaller<CppRpc::V1::Dispatcher>;
+
+      Buffer resultData;
+
+      Marshaller::SerializeResultHeader(resultData, correlationId);
+      Marshaller::SerializeErrorResult(resultData, exceptionData);
+
+      return resultData;
+    }
+
+    template <InterfaceMode Mode>
+    Buffer Dispatcher<Mode>::DoFunctionCall(BufferView callData)
+    {
+      Buffer resultData;
+
+      DoFunctionCall(m_FunctionTable, callData, resultData);
+
+      return resultData;
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::DoFunctionCall(const FunctionTablePointer& functionTablePointer, BufferView callData, Buffer& resultData, bool batchEntry)
+    {
+      using Marshaller = DefaultMarshaller<CppRpc::V1::Dispatcher>;
+
+      const std::size_t resultOffset = resultData.size();
+
+      CorrelationId correlationId = Detail::NoCorrelationId;
+
+      try
+      {
+        Detail::MessageHeader header = Marshaller::DeserializeMessageHeader(callData);
+
+        correlationId = header.m_CorrelationId;
+
+        switch (header.m_Type)
+        {
+          case Detail::MessageType::ResolveFunction:
+          {
+            Detail::FunctionIdentity functionIdentity = Marshaller::DeserializeResolveFunction(header.m_Payload);
+
+            FunctionId functionId = Detail::InvalidFunctionId;
+
+            {
+              Lock lock(m_Mutex);
+
+              auto interfaceIter = m_Interfaces.find({functionIdentity.m_InterfaceName, functionIdentity.m_InterfaceVersion});
+
+              if (interfaceIter != m_Interfaces.end())
+              {
+                auto functionIter = interfaceIter->second.find(functionIdentity.m_FunctionName);
+
+                if ((functionIter != interfaceIter->second.end()) && (*functionTablePointer.Read())[functionIter->second].IsRegistered())
+                {
+                  functionId = functionIter->second;
+                }
+              }
+            }
+
+            Marshaller::SerializeResultHeader(resultData, correlationId);
+            Marshaller::SerializeResolveFunctionResult(resultData, functionId, functionIdentity);
+
+            return;
+          }
+
+          case Detail::MessageType::FunctionCall:
+          {
+            Detail::RemoteFunctionCall functionCall = Marshaller::DeserializeFunctionCall(header.m_Payload);
+
+            // lock free, function table (and therefore the implementation) stays alive until the call is done
+            const auto functionTable = functionTablePointer.Read();
+
+            if ((functionCall.m_FunctionId >= functionTable->size()) || !(*functionTable)[functionCall.m_FunctionId].IsRegistered())
+            {
+              throw Detail::ExceptionImpl<UnknownFunction>((boost::format("Unknown function id %1%") % functionCall.m_FunctionId).str());
+            }
+
+            // call function implementation
+            Marshaller::SerializeResultHeader(resultData, correlationId);
+            ExecuteFunction((*functionTable)[functionCall.m_FunctionId], functionCall.m_ParameterData, resultData);
+
+            return;
+          }
+
+          case Detail::MessageType::OneWayCall:
+          {
+            // no result, not even for errors
+            DoOneWayFunctionCall(functionTablePointer, header.m_Payload);
+
+            return;
+          }
+
+          case Detail::MessageType::Batch:
+          {
+            if (batchEntry)
+            {
+              throw Detail::ExceptionImpl<MalformedMessage>("Nested batch message");
+            }
+
+            // one after the other, see SubmitFunctionCall() for parallel execution
+            Marshaller::SerializeBatchHeader(resultData, Detail::MessageType::BatchResult);
+
+            bool hasResults = false;
+
+            for (BufferView call : Marshaller::DeserializeBatch(header.m_Payload))
+            {
+              const std::size_t sizeOffset = Marshaller::BeginBatchMessage(resultData);
+
+              DoFunctionCall(functionTablePointer, call, resultData, true);
+
+              if (resultData.size() == sizeOffset + sizeof(Detail::BatchMessageSize))
+              {
+                // one-way call
+                resultData.resize(sizeOffset);
+              }
+              else
+              {
+                Marshaller::EndBatchMessage(resultData, sizeOffset);
+
+                hasResults = true;
+              }
+            }
+
+            // no reply to batches of one-way calls
+            if (!hasResults)
+            {
+              resultData.resize(resultOffset);
+            }
+
+            return;
+          }
+
+          default:
+            throw Detail::ExceptionImpl<MalformedMessage>((boost::format("Unknown message type %1%") % static_cast<unsigned>(header.m_Type)).str());
+        }
+      }
+
+      catch (const std::exception& e)
+      {
+        // drop partially serialized result
+        resultData.resize(resultOffset);
+
+        // report messages we are unable to handle back to the caller (if we got far enough to know the correlation id)
+        Marshaller::SerializeResultHeader(resultData, correlationId);
+        Marshaller::SerializeErrorResult(resultData, {typeid(e).name(), e.what()});
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::DoOneWayFunctionCall(const FunctionTablePointer& functionTablePointer, BufferView payload)
+    {
+      try
+      {
+        Detail::RemoteFunctionCall functionCall = DefaultMarshaller<CppRpc::V1::Dispatcher>::DeserializeFunctionCall(payload);
+
+        const auto functionTable = functionTablePointer.Read();
+
+        if ((functionCall.m_FunctionId >= functionTable->size()) || !(*functionTable)[functionCall.m_FunctionId].IsRegistered())
+        {
+          throw Detail::ExceptionImpl<UnknownFunction>((boost::format("Unknown function id %1%") % functionCall.m_FunctionId).str());
+        }
+
+        // only functions registered as one-way throw, others report exceptions as (ignored) result
+        Buffer ignoredResult;
+
+        ExecuteFunction((*functionTable)[functionCall.m_FunctionId], functionCall.m_ParameterData, ignoredResult);
+      }
+
+      catch (...)
+      {
+        ++m_OneWayExceptionCount;
+
+        ReportCurrentException("One-way function call failed");
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::ReportError(const std::string& description)
+    {
+      const auto errorHandler = m_ErrorHandler.Read();
+
+      if (*errorHandler)
+      {
+        try
+        {
+          (*errorHandler)(description);
+        }
+
+        catch (...)
+        {
+          // TODO: add trace / logging
+        }
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::ReportCurrentException(const char* context)
+    {
+      try
+      {
+        throw;
+      }
+
+      catch (const std::exception& e)
+      {
+        ReportError((boost::format("%1%, exception type: \"%2%\", what: \"%3%\"") % context % typeid(e).name() % e.what()).str());
+      }
+
+      catch (...)
+      {
+        ReportError((boost::format("%1%, unknown exception type") % context).str());
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::ExecuteFunction(const RegisteredFunction& function, BufferView parameterData, Buffer& resultData)
+    {
+      if (!function.m_ExecutionTime)
+      {
+        function.Call(parameterData, resultData);
+
+        return;
+      }
+
+      // per thread, counts the calls of all adaptive functions (no shared write)
+      thread_local std::uint32_t callCount = 0;
+
+      // only read after the first decision, the cache line stays shared between the cores
+      const std::uint32_t samples = function.m_ExecutionTime->m_Samples.load(std::memory_order_relaxed);
+
+      if ((samples >= AdaptiveSampleCount) && ((++callCount % AdaptiveResampleInterval) != 0))
+      {
+        function.Call(parameterData, resultData);
+
+        return;
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+
+      function.Call(parameterData, resultData);
+
+      const std::uint64_t executionTime = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+      // moving average over roughly the last 8 samples, concurrent updates may get lost (good enough for choosing the thread)
+      const std::uint64_t average = function.m_ExecutionTime->m_Average.load(std::memory_order_relaxed);
+
+      function.m_ExecutionTime->m_Average.store((average == UnknownExecutionTime) ? executionTime : (average - average / 8 + executionTime / 8), std::memory_order_relaxed);
+
+      if (samples < AdaptiveSampleCount)
+      {
+        function.m_ExecutionTime->m_Samples.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    template <InterfaceMode Mode>
+    bool Dispatcher<Mode>::IsInlineCall(const FunctionTablePointer& functionTablePointer, BufferView callData, bool batchEntry)
+    {
+      using Marshaller = DefaultMarshaller<CppRpc::V1::Dispatcher>;
+
+      try
+      {
+        const Detail::MessageHeader header = Marshaller::DeserializeMessageHeader(callData);
+
+        switch (header.m_Type)
+        {
+          case Detail::MessageType::FunctionCall:
+          case Detail::MessageType::OneWayCall:
+          {
+            const FunctionId functionId = Marshaller::DeserializeFunctionCall(header.m_Payload).m_FunctionId;
+
+            const auto functionTable = functionTablePointer.Read();
+
+            if (functionId >= functionTable->size())
+            {
+              // unknown function, reported right away
+              return true;
+            }
+
+            const RegisteredFunction& function = (*functionTable)[functionId];
+
+            switch (function.m_ExecutionPolicy)
+            {
+              case ExecutionPolicy::Inline:
+                return true;
+
+              case ExecutionPolicy::Adaptive:
+                // offloaded until measured
+                return function.m_ExecutionTime && (function.m_ExecutionTime->m_Average.load(std::memory_order_relaxed) < InlineExecutionTime);
+
+              default:
+                // unless not registered (reported right away)
+                return !function.IsRegistered();
+            }
+          }
+
+          case Detail::MessageType::Batch:
+          {
+            if (batchEntry)
+            {
+              throw Detail::ExceptionImpl<MalformedMessage>("Nested batch message");
+            }
+
+            // batches mixing inline and offloaded calls are executed in parallel on the worker threads
+            for (BufferView call : Marshaller::DeserializeBatch(header.m_Payload))
+            {
+              if (!IsInlineCall(functionTablePointer, call, true))
+              {
+                return false;
+              }
+            }
+
+            return true;
+          }
+
+          default:
+            // function resolution (a lookup) or malformed message (error result)
+            return true;
+        }
+      }
+
+      catch (const std::exception&)
+      {
+        // malformed messages are reported by DoFunctionCall()
+        return true;
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::SubmitFunctionCall(ServedTransport& transport, ConnectionId connection, Buffer&& callData)
+    {
+      using Marshaller = DefaultMarshaller<CppRpc::V1::Dispatcher>;
+
+      // state of a batch executed in parallel, the last call done sends the batch result
+      struct BatchState
+      {
+        Buffer                   m_BatchData;
+        std::vector<BufferView>  m_Calls;           // refer to m_BatchData
+        std::vector<Buffer>      m_Results;         // size prefixed, see Marshaller::BeginBatchMessage()
+        std::atomic<std::size_t> m_RemainingCalls;
+      };
+
+      std::shared_ptr<BatchState> batch;
+
+      try
+      {
+        const Detail::MessageHeader header = Marshaller::DeserializeMessageHeader(callData);
+
+        if (header.m_Type == Detail::MessageType::Batch)
+        {
+          batch = std::make_shared<BatchState>();
+
+          // small batches are stored inline and move with the buffer, the views are taken afterwards
+          batch->m_BatchData = std::move(callData);
+          batch->m_Calls = Marshaller::DeserializeBatch(Marshaller::DeserializeMessageHeader(batch->m_BatchData).m_Payload);
+          batch->m_Results.resize(batch->m_Calls.size());
+          batch->m_RemainingCalls = batch->m_Calls.size();
+        }
+      }
+
+      catch (const std::exception&)
+      {
+        // malformed messages are reported by DoFunctionCall()
+        if (batch)
+        {
+          callData = std::move(batch->m_BatchData);
+          batch.reset();
+        }
+      }
+
+      // the transport is kept served until the result was sent, see StopServing()
+      ++transport.m_SubmittedCalls;
+
+      if (!batch || batch->m_Calls.empty())
+      {
+        // responses are sent as soon as each call is done, not necessarily in the order the calls were received
+        m_WorkerThreads->Submit([this, &transport, connection, callData = std::move(callData)]
+                                {
+                                  const SubmittedCall submittedCall(transport);
+
+                                  try
+                                  {
+                                    Buffer resultData = transport.m_Transport.Acquire();
+
+                                    DoFunctionCall(m_FunctionTable, callData, resultData);
+
+                                    if (!resultData.empty())
+                                    {
+                                      SendResult(transport.m_Transport, connection, std::move(resultData));
+                                    }
+                                  }
+
+                                  catch (...)
+                                  {
+                                    ReportCurrentException("Function call failed on worker thread");
+                                  }
+                                });
+
+        return;
+      }
+
+      for (std::size_t i = 0; i < batch->m_Calls.size(); ++i)
+      {
+        m_WorkerThreads->Submit([this, &transport, connection, batch, i]
+                                {
+                                  Buffer& result = batch->m_Results[i];
+
+                                  try
+                                  {
+                                    const std::size_t sizeOffset = Marshaller::BeginBatchMessage(result);
+
+                                    DoFunctionCall(m_FunctionTable, batch->m_Calls[i], result, true);
+
+                                    Marshaller::EndBatchMessage(result, sizeOffset);
+                                  }
+
+                                  catch (...)
+                                  {
+                                    // no result for this call, the other results are still sent
+                                    result.clear();
+
+                                    ReportCurrentException("Batched function call failed on worker thread");
+                                  }
+
+                                  if (--batch->m_RemainingCalls == 0)
+                                  {
+                                    const SubmittedCall submittedCall(transport);
+
+                                    SendBatchResult(transport.m_Transport, connection, batch->m_Results);
+                                  }
+                                });
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::SendResult(Transport<Mode>& transport, ConnectionId connection, Buffer&& resultData)
+    {
+      using Marshaller = DefaultMarshaller<CppRpc::V1::Dispatcher>;
+
+      Detail::MessageType type = Detail::MessageType::Result;
+      CorrelationId correlationId = Detail::NoCorrelationId;
+
+      Detail::RemoteExceptionData exceptionData;
+
+      try
+      {
+        const Detail::MessageHeader header = Marshaller::DeserializeMessageHeader(resultData);
+
+        type = header.m_Type;
+        correlationId = header.m_CorrelationId;
+
+        transport.CommitTo(connection, std::move(resultData));
+
+        return;
+      }
+
+      catch (const std::exception& e)
+      {
+        exceptionData = {typeid(e).name(), (boost::format("Unable to send result: %1%") % e.what()).str()};
+      }
+
+      catch (...)
+      {
+        exceptionData = {typeid(UnknowRemoteException).name(), "Unable to send result"};
+      }
+
+      try
+      {
+        if ((type == Detail::MessageType::BatchResult) && !resultData.empty())
+        {
+          // e.g. too big as a whole, every result of the batch is a complete result message of its own
+          for (BufferView result : Marshaller::DeserializeBatch(Marshaller::DeserializeMessageHeader(resultData).m_Payload))
+          {
+            SendResult(transport, connection, Buffer(result.begin(), result.end()));
+          }
+        }
+        else
+        {
+          // much smaller than the result, the caller gets the reason instead of waiting forever
+          transport.CommitTo(connection, MakeErrorResult(correlationId, exceptionData));
+        }
+      }
+
+      catch (...)
+      {
+        ++m_UnsentResultCount;
+
+        ReportCurrentException("Sending result failed");
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::SendBatchResult(Transport<Mode>& transport, ConnectionId connection, const std::vector<Buffer>& results)
+    {
+      using Marshaller = DefaultMarshaller<CppRpc::V1::Dispatcher>;
+
+      try
+      {
+        // batch header and results are gathered by the transport, no need to concatenate them
+        Buffer header;
+
+        Marshaller::SerializeBatchHeader(header, Detail::MessageType::BatchResult);
+
+        typename Transport<Mode>::Segments segments = {header};
+
+        for (const Buffer& result : results)
+        {
+          // none for one-way calls
+          if (result.size() > sizeof(Detail::BatchMessageSize))
+          {
+            segments.push_back(result);
+          }
+        }
+
+        if (segments.size() > 1)
+        {
+          transport.SendTo(connection, segments);
+        }
+
+        return;
+      }
+
+      catch (...)
+      {
+        // e.g. too big as a whole, the results are sent one by one below
+      }
+
+      // every result is a complete result message of its own after the size prefix
+      for (const Buffer& result : results)
+      {
+        if (result.size() > sizeof(Detail::BatchMessageSize))
+        {
+          try
+          {
+            SendResult(transport, connection, Buffer(result.begin() + sizeof(Detail::BatchMessageSize), result.end()));
+          }
+
+          catch (...)
+          {
+            // copying the result failed
+            ++m_UnsentResultCount;
+
+            ReportCurrentException("Sending batch result failed");
+          }
+        }
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::ServerThread(Dispatcher<Mode>* dispatcher, ServedTransport* transport)
+    {
+      assert((dispatcher != nullptr) && (transport != nullptr));
+
+      Transport<Mode>& serverTransport = transport->m_Transport;
+
+      // shards use their own copy, see ServerMode::ShardPerCore
+      const FunctionTablePointer& functionTable = transport->m_FunctionTable ? *transport->m_FunctionTable : dispatcher->m_FunctionTable;
+
+      if (transport->m_FunctionTable)
+      {
+        Detail::PinCurrentThread(transport->m_Core);
+      }
+
+      Buffer callData;
+      BufferView lentCallData;
+      ConnectionId connection;
+
+      for (;;)
+      {        
+        if (dispatcher->m_WorkerThreads)
+        {
+          // worker threads need their own copy of the call
+          if (serverTransport.ReceiveFrom(callData, connection))  // blocks until a message arrives or the transport is interrupted, see StopServing()
+          {
+            try
+            {
+              if (IsInlineCall(functionTable, callData))
+              {
+                // cheaper than a hand-off to a worker thread, see ExecutionPolicy
+                Buffer resultData = serverTransport.Acquire();
+
+                dispatcher->DoFunctionCall(functionTable, callData, resultData);
+
+                if (!resultData.empty())
+                {
+                  dispatcher->SendResult(serverTransport, connection, std::move(resultData));
+                }
+              }
+              else
+              {
+                dispatcher->SubmitFunctionCall(*transport, connection, std::move(callData));
+              }
+            }
+
+            catch (...)
+            {
+              dispatcher->ReportCurrentException("Function call failed on server thread");
+            }
+
+            callData.clear();
+          }
+        }
+        else if (serverTransport.ReceiveLentFrom(lentCallData, connection))  // blocks until a message arrives or the transport is interrupted, see StopServing()
+        {
+          // call is decoded in place, result serialized straight into a buffer of the transport
+          Buffer resultData;
+
+          try
+          {
+            resultData = serverTransport.Acquire();
+
+            dispatcher->DoFunctionCall(functionTable, lentCallData, resultData);
+          }
+
+          catch (...)
+          {
+            resultData.clear();
+
+            dispatcher->ReportCurrentException("Function call failed on server thread");
+          }
+
+          serverTransport.Return();
+
+          // no result for one-way calls
+          if (!resultData.empty())
+          {
+            dispatcher->SendResult(serverTransport, connection, std::move(resultData));
+          }
+        }
+
+        if (transport->m_Stop)
+        {
+          return;
+        }
+      }
+    }
+
+    template <InterfaceMode Mode>
+    void Dispatcher<Mode>::ClientThread(Dispatcher<Mode>* dispatcher)
+    {
+      assert(dispatcher != nullptr);
+
+      Buffer resultData;
+
+      for (;;)
+      {
+        try
+        {
+          if (dispatcher->m_Transport.Receive(resultData))  // blocks until a message arrives or the transport is interrupted, see ~Dispatcher()
+          {
+            dispatcher->CompleteRemoteFunctionCall(std::move(resultData));
+
+            resultData.clear();
+          }
+        }
+
+        catch (const std::exception& e)
+        {
+          // connection lost, no result is ever going to arrive
+          dispatcher->FailPendingCalls({typeid(e).name(), e.what()});
+
+          return;
+        }
 
-        if (dispatcher->m_StopServerThread)
+        if (dispatcher->m_StopReceiveThread)
         {
           return;
         }
@@ -260,10 +1561,10 @@ namespace CppRpc
     template <InterfaceMode Mode>
     using DispatcherHandle = std::shared_ptr<Dispatcher<Mode>>;
 
-    template <template <InterfaceMode> class Transport>
-    DispatcherHandle<Transport::Mode> MakeDispatcherHandle(Transport& transport)
+    template <typename Transport>
+    DispatcherHandle<Transport::Mode> MakeDispatcherHandle(Transport& transport, std::size_t workerThreadCount = 0, ServerMode serverMode = ServerMode::Shared)
     {
-      return std::make_shared<DispatcherHandle<Transport::Mode>::element_type>(transport);
+      return std::make_shared<typename DispatcherHandle<Transport::Mode>::element_type>(transport, workerThreadCount, serverMode);
     }
 
 //    template <InterfaceMode Mode>
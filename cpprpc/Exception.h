@@ -4,6 +4,9 @@
 #pragma once
 
 #include <exception>
+#include <string>
+#include <utility>
+#include <type_traits>
 
 
 namespace CppRpc
@@ -21,7 +24,7 @@ namespace CppRpc
       public:
         virtual ~ExceptionInterface() noexcept = default;
 
-        virtual const char* what() const = 0;
+        virtual const char* what() const noexcept = 0;
     };
 
     struct Exception : virtual std::exception, ExceptionInterface {};
@@ -35,6 +38,9 @@ namespace CppRpc
     struct UnknownInterface         : LocalException {};
     struct UnknownFunction          : LocalException {};
     struct UnknownInterfaceMode     : LocalException {};
+    struct UnknownTransport         : LocalException {};
+    struct MalformedMessage         : LocalException {};
+    struct TransportError           : LocalException {};
 
     struct UnknowRemoteException : RemoteException {};
 
@@ -50,7 +56,7 @@ namespace CppRpc
           : Interface(), m_What(std::forward<T>(what))
           {}
 
-          virtual const char* what() const override
+          virtual const char* what() const noexcept override
           {
             return m_What.c_str();
           }
@@ -4,16 +4,20 @@
 #pragma once
 
 #include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <algorithm>
 #include <cassert>
 
 #include <boost/function_types/result_type.hpp>
 #include <boost/function_types/parameter_types.hpp>
-#include <boost/variant/get.hpp>
 #include <boost/format.hpp>
 
 #include "cpprpc/Types.h"
 #include "cpprpc/Dispatcher.h"
 #include "cpprpc/Exception.h"
+#include "cpprpc/AsyncResult.h"
 
 
 namespace CppRpc
@@ -63,65 +67,122 @@ namespace CppRpc
       template <typename T, template <InterfaceMode> class Dispatcher>
       class FunctionImpl<T, InterfaceMode::Client, Dispatcher> : public FunctionImplBase<T, InterfaceMode::Client, Dispatcher>
       {
+        private:
+          using Base = FunctionImplBase<T, InterfaceMode::Client, Dispatcher>;
+
+          using typename Base::ReturnType;
+          using typename Base::ParamTypes;
+
         public:
+          // the execution policy is up to the server, accepted to share function declarations with it
           template <typename Implementation>
-          FunctionImpl(Interface<InterfaceMode::Client, Dispatcher>& interface, const Name& name, Implementation&& /*implementation*/)
-          : FunctionImplBase(interface, name)
+          FunctionImpl(Interface<InterfaceMode::Client, Dispatcher>& interface, const Name& name, Implementation&& /*implementation*/, ExecutionPolicy = ExecutionPolicy::Offload)
+          : Base(interface, name), m_OneWay(false), m_ResolveFlag(), m_CallHeader(), m_CallSizeHint(0)
           {}
 
+          template <typename Implementation>
+          FunctionImpl(Interface<InterfaceMode::Client, Dispatcher>& interface, const Name& name, Implementation&& /*implementation*/, OneWayFunctionTag,
+                       ExecutionPolicy = ExecutionPolicy::Offload)
+          : Base(interface, name), m_OneWay(true), m_ResolveFlag(), m_CallHeader(), m_CallSizeHint(0)
+          {
+            static_assert(std::is_void<ReturnType>::value, "one-way functions must not return a value");
+          }
+
           virtual ~FunctionImpl() noexcept override = default;
 
+          // one-way functions return as soon as the call was handed to the transport
           template <typename... Arguments>
           ReturnType operator()(Arguments&&... arguments)
           {
-            // TODO: do not use default marshaller ...
-
-            // serialize function call
-            Buffer callData = DefaultMarshaller<Dispatcher>::SerializeFunctionCall<ParamTypes>(m_Interface, m_Name, std::forward<Arguments>(arguments)...);
-          
             // do remote function call
-            Buffer returnData = m_Interface.GetDispatcher()->CallRemoteFunction(callData);
+            return Call(SerializeCall(std::forward<Arguments>(arguments)...), std::is_void<ReturnType>());
+          }
 
-            // de-serialize result (return value or exception)
-            Detail::RemoteCallResult<ReturnType> result = DefaultMarshaller<Dispatcher>::DeserializeReturnValue<Detail::RemoteCallResult<ReturnType>>(returnData);
+          // returns without waiting for the result, the first call of a function blocks until its function id is resolved
+          template <typename... Arguments>
+          AsyncResult<ReturnType> AsyncCall(Arguments&&... arguments)
+          {
+            Buffer callData = SerializeCall(std::forward<Arguments>(arguments)...);
 
-            assert(!result.empty());
+            auto state = std::make_shared<Detail::AsyncState<ReturnType>>();
 
-            // check if exception data was returned instead of a return value
-            if (result.which() != 0)
+            if (m_OneWay)
             {
-              const Detail::RemoteExceptionData& exceptionData = boost::get<Detail::RemoteExceptionData>(result);
-
-              // TODO: add handling for registred exception types
-              // throw de-serialize exception
-              throw Detail::ExceptionImpl<UnknowRemoteException>((boost::format("Exception type: \"%1%\", what: \"%2%\"") % exceptionData.m_Name % exceptionData.m_What).str());
+              // done as soon as the call was handed to the transport
+              state->Complete([this, &callData] { return Call(std::move(callData), std::is_void<ReturnType>()); });
+            }
+            else
+            {
+              // completed on the receive thread, must not refer to this function (may be gone by then)
+              this->m_Interface.GetDispatcher()->CallRemoteFunctionAsync(std::move(callData), [state] (Detail::ResultMessage resultMessage)
+                {
+                  state->Complete([&resultMessage] { return ExtractResult(resultMessage); });
+                });
             }
-            
-            // return result
-            return ReturnValueHelper<ReturnType>::Extract(result);
+
+            return AsyncResult<ReturnType>(std::move(state));
           }
 
         private:
+          const bool               m_OneWay;
+          std::once_flag           m_ResolveFlag;
+          Buffer                   m_CallHeader;    // pre-encoded call header (incl. function id), see Marshaller::SerializeFunctionCallHeader()
+          std::atomic<std::size_t> m_CallSizeHint;  // biggest call seen so far, used to reserve the call buffer up front
 
-          // helper for void return type
-          template <typename ReturnValue>
-          struct ReturnValueHelper
+          // only functions without return value may be one-way (see constructor)
+          ReturnType Call(Buffer callData, std::false_type /*isVoid*/)
           {
-            template <typename RemoteCallResult>
-            static auto Extract(RemoteCallResult& result)
-            {
-              return std::move(boost::get<ReturnValue>(result));
-            }
-          };
+            return ExtractResult(this->m_Interface.GetDispatcher()->CallRemoteFunction(std::move(callData)));
+          }
 
-          template <>
-          struct ReturnValueHelper<void>
+          void Call(Buffer callData, std::true_type /*isVoid*/)
           {
-            template <typename RemoteCallResult>
-            static void Extract(RemoteCallResult& /*result*/)
+            if (m_OneWay)
+            {
+              this->m_Interface.GetDispatcher()->CallRemoteFunctionOneWay(std::move(callData));
+            }
+            else
             {
+              ExtractResult(this->m_Interface.GetDispatcher()->CallRemoteFunction(std::move(callData)));
             }
-          };
+          }
+
+          template <typename... Arguments>
+          Buffer SerializeCall(Arguments&&... arguments)
+          {
+            // TODO: do not use default marshaller ...
+
+            // resolve function id on first call, retried with next call if resolving failed
+            std::call_once(m_ResolveFlag, [this] { Resolve(); });
+
+            // serialize function call, checks arguments at compile time
+            // serialized straight into a buffer of the transport
+            Buffer callData = DefaultMarshaller<Dispatcher>::template SerializeFunctionCall<ParamTypes>(this->m_Interface.GetDispatcher()->AcquireBuffer(), m_CallHeader, m_CallSizeHint.load(std::memory_order_relaxed), std::forward<Arguments>(arguments)...);
+
+            UpdateCallSizeHint(callData.size());
+
+            return callData;
+          }
+
+          static ReturnType ExtractResult(const Detail::ResultMessage& resultMessage)
+          {
+            // de-serialize result (return value or exception)
+            return DefaultMarshaller<Dispatcher>::template DeserializeResult<ReturnType>(resultMessage.GetPayload());
+          }
+
+          void Resolve()
+          {
+            Detail::ResultMessage resultMessage = this->m_Interface.GetDispatcher()->CallRemoteFunction(DefaultMarshaller<Dispatcher>::SerializeResolveFunction(this->m_Interface, this->m_Name));
+
+            m_CallHeader = DefaultMarshaller<Dispatcher>::SerializeFunctionCallHeader(DefaultMarshaller<Dispatcher>::DeserializeResolveFunctionResult(resultMessage.GetPayload()), m_OneWay);
+          }
+
+          void UpdateCallSizeHint(std::size_t callSize)
+          {
+            auto sizeHint = m_CallSizeHint.load(std::memory_order_relaxed);
+
+            while ((callSize > sizeHint) && !m_CallSizeHint.compare_exchange_weak(sizeHint, callSize, std::memory_order_relaxed));
+          }
 
       };  // class FunctionImpl<InterfaceMode::Client>
 
@@ -129,26 +190,50 @@ namespace CppRpc
       template <typename T, template <InterfaceMode> class Dispatcher>
       class FunctionImpl<T, InterfaceMode::Server, Dispatcher> : public FunctionImplBase<T, InterfaceMode::Server, Dispatcher>
       {
+        private:
+          using Base = FunctionImplBase<T, InterfaceMode::Server, Dispatcher>;
+
+          using typename Base::ReturnType;
+          using typename Base::ParamTypes;
+
         public:
           template <typename Implementation>
-          FunctionImpl(Interface<InterfaceMode::Server, Dispatcher>& interface, const Name& name, Implementation&& implementation)
-          : FunctionImplBase(interface, name), m_Implementation(std::forward<Implementation>(implementation))
+          FunctionImpl(Interface<InterfaceMode::Server, Dispatcher>& interface, const Name& name, Implementation&& implementation, ExecutionPolicy executionPolicy = ExecutionPolicy::Offload)
+          : Base(interface, name), m_Implementation(std::forward<Implementation>(implementation))
           {
-            auto marshalledImplementation = [this] (const Buffer& paramData) -> Buffer
+            auto marshalledImplementation = [this] (BufferView paramData, Buffer& resultData)
               { 
                 // TODO: do not use default dipatcher ...
-                return DefaultMarshaller<Dispatcher>::DeserializeAndExecuteFunctionCall<ReturnType, ParamTypes>(paramData, m_Implementation);
+                DefaultMarshaller<Dispatcher>::template DeserializeAndExecuteFunctionCall<ReturnType, ParamTypes>(paramData, resultData, m_Implementation);
               };
 
             // register function
-            m_Interface.GetDispatcher()->RegisterFunctionImplementation(m_Interface, m_Name, marshalledImplementation);
+            this->m_Interface.GetDispatcher()->RegisterFunctionImplementation(this->m_Interface, this->m_Name, marshalledImplementation, executionPolicy);
+          }
+
+          // exceptions thrown by one-way functions are counted and logged by the dispatcher
+          template <typename Implementation>
+          FunctionImpl(Interface<InterfaceMode::Server, Dispatcher>& interface, const Name& name, Implementation&& implementation, OneWayFunctionTag,
+                       ExecutionPolicy executionPolicy = ExecutionPolicy::Offload)
+          : Base(interface, name), m_Implementation(std::forward<Implementation>(implementation))
+          {
+            static_assert(std::is_void<ReturnType>::value, "one-way functions must not return a value");
+
+            auto marshalledImplementation = [this] (BufferView paramData, Buffer& /*resultData*/)
+              { 
+                // TODO: do not use default dipatcher ...
+                DefaultMarshaller<Dispatcher>::template DeserializeAndExecuteOneWayFunctionCall<ParamTypes>(paramData, m_Implementation);
+              };
+
+            // register function
+            this->m_Interface.GetDispatcher()->RegisterFunctionImplementation(this->m_Interface, this->m_Name, marshalledImplementation, executionPolicy);
           }
 
           virtual ~FunctionImpl() noexcept override
           {
             try
             {
-              m_Interface.GetDispatcher()->DeregisterFunctionImplementation(m_Interface, m_Name);
+              this->m_Interface.GetDispatcher()->DeregisterFunctionImplementation(this->m_Interface, this->m_Name);
             }
 
             catch (...)
@@ -168,8 +253,14 @@ namespace CppRpc
       {
         public:
           template <typename Implementation>
-          Function(Interface<Mode, Dispatcher>& interface, const Name& name, Implementation&& implementation)
-          : FunctionImpl(interface, name, std::forward<Implementation>(implementation))
+          Function(Interface<Mode, Dispatcher>& interface, const Name& name, Implementation&& implementation, ExecutionPolicy executionPolicy = ExecutionPolicy::Offload)
+          : Detail::FunctionImpl<T, Mode, Dispatcher>(interface, name, std::forward<Implementation>(implementation), executionPolicy)
+          {}
+
+          template <typename Implementation>
+          Function(Interface<Mode, Dispatcher>& interface, const Name& name, Implementation&& implementation, OneWayFunctionTag oneWay,
+                   ExecutionPolicy executionPolicy = ExecutionPolicy::Offload)
+          : Detail::FunctionImpl<T, Mode, Dispatcher>(interface, name, std::forward<Implementation>(implementation), oneWay, executionPolicy)
           {}
 
           virtual ~Function() noexcept override = default;        
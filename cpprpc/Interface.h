@@ -27,7 +27,10 @@ namespace CppRpc
     class Interface
     {
       public:
-        using DispatcherHandle = DispatcherHandle<Mode>;
+        using DispatcherHandle = CppRpc::V1::DispatcherHandle<Mode>;
+
+        // client side call batching, see Dispatcher::Batch
+        using Batch = typename Dispatcher<Mode>::Batch;
 
         Interface(Transport<Mode>& transport, const Name& name, Version version = {1, 0})
         : Interface(MakeDispatcherHandle(transport), name, version)
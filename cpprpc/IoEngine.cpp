@@ -0,0 +1,839 @@
+#include "cpprpc/IoEngine.h"
+
+#if defined(__linux__)
+
+#include <unordered_map>
+#include <vector>
+#include <system_error>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <cassert>
+#include <csignal>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <linux/io_uring.h>
+
+#include <boost/format.hpp>
+
+#include "cpprpc/Exception.h"
+
+// multishot receive into a registered buffer ring needs recent kernel headers (Linux 6.0)
+#if defined(__NR_io_uring_setup) && defined(IORING_RECV_MULTISHOT)
+#define CPPRPC_HAS_IO_URING
+#endif
+
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+    namespace Detail
+    {
+
+      FileDescriptor::~FileDescriptor()
+      {
+        Reset();
+      }
+
+      void FileDescriptor::Reset(int fd)
+      {
+        if (m_Fd >= 0)
+        {
+          close(m_Fd);
+        }
+
+        m_Fd = fd;
+      }
+
+
+      void ThrowTransportError(const std::string& what, int error)
+      {
+        throw ExceptionImpl<TransportError>((boost::format("%1%: %2%") % what % std::error_code(error, std::system_category()).message()).str());
+      }
+
+
+      IoEngine::IoEngine()
+      : m_InterruptEvent(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)), m_Interrupted(false)
+      {
+        if (m_InterruptEvent.Get() < 0)
+        {
+          ThrowTransportError("Unable to create eventfd");
+        }
+      }
+
+      void IoEngine::Interrupt()
+      {
+        const std::uint64_t value = 1;
+
+        // can only fail if the counter would overflow, the event is still signalled then
+        const ssize_t result = write(m_InterruptEvent.Get(), &value, sizeof(value));
+        static_cast<void>(result);
+      }
+
+      void IoEngine::AddInterruptListener()
+      {
+        AddListener(m_InterruptEvent.Get(), [this]
+          {
+            std::uint64_t value = 0;
+
+            if (read(m_InterruptEvent.Get(), &value, sizeof(value)) == sizeof(value))
+            {
+              m_Interrupted = true;
+            }
+          });
+      }
+
+      bool IoEngine::ConsumeInterrupt()
+      {
+        const bool interrupted = m_Interrupted;
+
+        m_Interrupted = false;
+
+        return interrupted;
+      }
+
+    }  // namespace Detail
+
+
+    namespace
+    {
+
+      using namespace Detail;
+
+      // size of the chunks received at once
+      const std::size_t ReceiveChunkSize = 16 * 1024;
+
+
+      // maximum number of files received with a single recvmsg()
+      const std::size_t MaxReceivedFiles = 8;
+
+      // reads from a non-blocking socket until it would block or was closed, see IoEngine::ReceiveHandler and IoEngine::FileHandler
+      void ReceiveAvailable(int socket, Buffer& buffer, const IoEngine::ReceiveHandler& handler, const IoEngine::FileHandler& fileHandler)
+      {
+        for (;;)
+        {
+          ssize_t result;
+
+          if (fileHandler)
+          {
+            union
+            {
+              cmsghdr m_Header;  // alignment
+              char    m_Data[CMSG_SPACE(MaxReceivedFiles * sizeof(int))];
+            } control;
+
+            iovec part = {buffer.data(), buffer.size()};
+
+            msghdr message = {};
+
+            message.msg_iov = &part;
+            message.msg_iovlen = 1;
+            message.msg_control = control.m_Data;
+            message.msg_controllen = sizeof(control.m_Data);
+
+            result = recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+
+            if (result >= 0)
+            {
+              for (cmsghdr* header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header))
+              {
+                if ((header->cmsg_level == SOL_SOCKET) && (header->cmsg_type == SCM_RIGHTS))
+                {
+                  const std::size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+                  for (std::size_t i = 0; i < count; ++i)
+                  {
+                    int file;
+
+                    std::memcpy(&file, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+
+                    fileHandler(file);
+                  }
+                }
+              }
+            }
+          }
+          else
+          {
+            result = recv(socket, buffer.data(), buffer.size(), 0);
+          }
+
+          if (result > 0)
+          {
+            handler(BufferView(buffer.data(), static_cast<std::size_t>(result)));
+
+            // drained, saves the recv() failing with EAGAIN (recvmsg() stops early at received files)
+            if (!fileHandler && (static_cast<std::size_t>(result) < buffer.size()))
+            {
+              return;
+            }
+          }
+          else if ((result < 0) && (errno == EINTR))
+          {
+            continue;
+          }
+          else if ((result < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+          {
+            return;
+          }
+          else
+          {
+            // closed by peer or failed
+            handler(BufferView());
+
+            return;
+          }
+        }
+      }
+
+
+      // readiness based engine, data is read by recv() after epoll reported a socket readable
+      class EpollEngine : public IoEngine
+      {
+        public:
+          EpollEngine()
+          : IoEngine(), m_Epoll(epoll_create1(EPOLL_CLOEXEC)), m_Registrations(), m_ReceiveBuffer(ReceiveChunkSize)
+          {
+            if (m_Epoll.Get() < 0)
+            {
+              ThrowTransportError("Unable to create epoll instance");
+            }
+
+            AddInterruptListener();
+          }
+
+          virtual ~EpollEngine() noexcept override = default;
+
+          virtual IoEngineType GetType() const override
+          {
+            return IoEngineType::Epoll;
+          }
+
+          virtual void AddListener(int socket, ReadyHandler handler) override
+          {
+            Add(socket, std::make_shared<Registration>(Registration{std::move(handler), nullptr, nullptr}));
+          }
+
+          virtual void AddReceiver(int socket, ReceiveHandler handler, FileHandler fileHandler) override
+          {
+            Add(socket, std::make_shared<Registration>(Registration{nullptr, std::move(handler), std::move(fileHandler)}));
+          }
+
+          virtual void Remove(int socket) override
+          {
+            if (m_Registrations.erase(socket) > 0)
+            {
+              epoll_ctl(m_Epoll.Get(), EPOLL_CTL_DEL, socket, nullptr);
+            }
+          }
+
+          virtual bool Wait(std::chrono::steady_clock::time_point deadline) override
+          {
+            epoll_event events[MaxEvents];
+
+            int count = -1;
+
+            while (count < 0)
+            {
+              const auto now = std::chrono::steady_clock::now();
+
+              if (now >= deadline)
+              {
+                return false;
+              }
+
+              // round up, avoids busy waiting for the last fraction of a millisecond
+              const auto timeout = (deadline == std::chrono::steady_clock::time_point::max()) ? std::chrono::milliseconds(-1) :
+                                     std::min(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now + std::chrono::microseconds(999)),
+                                              std::chrono::milliseconds(std::numeric_limits<int>::max()));
+
+              count = epoll_wait(m_Epoll.Get(), events, MaxEvents, static_cast<int>(timeout.count()));
+
+              if ((count < 0) && (errno != EINTR))
+              {
+                ThrowTransportError("epoll_wait failed");
+              }
+            }
+
+            for (int i = 0; i < count; ++i)
+            {
+              const auto registration = m_Registrations.find(events[i].data.fd);
+
+              // removed by a handler called before
+              if (registration == m_Registrations.end())
+              {
+                continue;
+              }
+
+              // keeps the handler alive even if it removes itself
+              const std::shared_ptr<Registration> current = registration->second;
+
+              if (current->m_Ready)
+              {
+                current->m_Ready();
+              }
+              else
+              {
+                ReceiveAvailable(events[i].data.fd, m_ReceiveBuffer, current->m_Receive, current->m_Files);
+              }
+            }
+
+            return (count > 0) && !ConsumeInterrupt();
+          }
+
+        private:
+          static const int MaxEvents = 64;
+
+          struct Registration
+          {
+            ReadyHandler   m_Ready;
+            ReceiveHandler m_Receive;
+            FileHandler    m_Files;
+          };
+
+          FileDescriptor                                        m_Epoll;
+          std::unordered_map<int, std::shared_ptr<Registration>> m_Registrations;
+          Buffer                                                m_ReceiveBuffer;
+
+          void Add(int socket, std::shared_ptr<Registration> registration)
+          {
+            epoll_event event = {};
+
+            event.events = EPOLLIN;
+            event.data.fd = socket;
+
+            if (epoll_ctl(m_Epoll.Get(), EPOLL_CTL_ADD, socket, &event) != 0)
+            {
+              ThrowTransportError("Unable to add socket to epoll");
+            }
+
+            m_Registrations[socket] = std::move(registration);
+          }
+      };
+
+
+#ifdef CPPRPC_HAS_IO_URING
+
+      // owns a memory mapping
+      class MemoryMapping : boost::noncopyable
+      {
+        public:
+          MemoryMapping()
+          : m_Address(MAP_FAILED), m_Size(0)
+          {}
+
+          ~MemoryMapping()
+          {
+            if (m_Address != MAP_FAILED)
+            {
+              munmap(m_Address, m_Size);
+            }
+          }
+
+          void Map(std::size_t size, int flags, int fd, off_t offset)
+          {
+            assert(m_Address == MAP_FAILED);
+
+            m_Address = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, offset);
+
+            if (m_Address == MAP_FAILED)
+            {
+              ThrowTransportError("Unable to map io_uring memory");
+            }
+
+            m_Size = size;
+          }
+
+          template <typename T>
+          T* Get(std::size_t offset = 0) const
+          {
+            return reinterpret_cast<T*>(static_cast<Byte*>(m_Address) + offset);
+          }
+
+        private:
+          void*       m_Address;
+          std::size_t m_Size;
+      };
+
+      bool IsKernelVersionAtLeast(int major, int minor)
+      {
+        utsname name;
+
+        int kernelMajor = 0;
+        int kernelMinor = 0;
+
+        return (uname(&name) == 0) && (std::sscanf(name.release, "%d.%d", &kernelMajor, &kernelMinor) == 2) &&
+               ((kernelMajor > major) || ((kernelMajor == major) && (kernelMinor >= minor)));
+      }
+
+
+      // completion based engine, the kernel receives into a ring of registered buffers (multishot receive), re-arming and
+      // removing sockets is submitted together with the next wait, so a single system call handles all sockets
+      class IoUringEngine : public IoEngine
+      {
+        public:
+          IoUringEngine()
+          : IoEngine(), m_Ring(), m_RingMemory(), m_SqeMemory(), m_BufferRingMemory(), m_Buffers(BufferCount * ReceiveChunkSize), m_BufferRingTail(0), m_PolledReceiveBuffer(ReceiveChunkSize),
+            m_SqTail(0), m_PendingSubmissions(0), m_PendingOperations(0), m_NextId(0), m_Registrations()
+          {
+            if (!IsKernelVersionAtLeast(6, 0))
+            {
+              throw ExceptionImpl<TransportError>("io_uring multishot receive needs Linux 6.0 or newer");
+            }
+
+            io_uring_params params = {};
+
+            // completions are processed with the next io_uring_enter() of the receiving thread, no need to interrupt it
+            params.flags = IORING_SETUP_CLAMP | IORING_SETUP_COOP_TASKRUN;
+
+            m_Ring.Reset(static_cast<int>(syscall(__NR_io_uring_setup, RingEntries, &params)));
+
+            if (m_Ring.Get() < 0)
+            {
+              ThrowTransportError("Unable to create io_uring instance");
+            }
+
+            if (((params.features & IORING_FEAT_SINGLE_MMAP) == 0) || ((params.features & IORING_FEAT_EXT_ARG) == 0))
+            {
+              throw ExceptionImpl<TransportError>("io_uring instance lacks needed features");
+            }
+
+            // submission and completion queue share a single mapping
+            m_RingMemory.Map(std::max(params.sq_off.array + params.sq_entries * sizeof(std::uint32_t), params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe)),
+                             MAP_SHARED | MAP_POPULATE, m_Ring.Get(), IORING_OFF_SQ_RING);
+            m_SqeMemory.Map(params.sq_entries * sizeof(io_uring_sqe), MAP_SHARED | MAP_POPULATE, m_Ring.Get(), IORING_OFF_SQES);
+
+            m_SqHead = m_RingMemory.Get<std::uint32_t>(params.sq_off.head);
+            m_SqTailShared = m_RingMemory.Get<std::uint32_t>(params.sq_off.tail);
+            m_SqMask = *m_RingMemory.Get<std::uint32_t>(params.sq_off.ring_mask);
+            m_SqEntries = params.sq_entries;
+            m_SqArray = m_RingMemory.Get<std::uint32_t>(params.sq_off.array);
+            m_Sqes = m_SqeMemory.Get<io_uring_sqe>();
+
+            m_CqHead = m_RingMemory.Get<std::uint32_t>(params.cq_off.head);
+            m_CqTail = m_RingMemory.Get<std::uint32_t>(params.cq_off.tail);
+            m_CqMask = *m_RingMemory.Get<std::uint32_t>(params.cq_off.ring_mask);
+            m_Cqes = m_RingMemory.Get<io_uring_cqe>(params.cq_off.cqes);
+
+            m_SqTail = *m_SqTailShared;
+
+            // register ring of receive buffers, the kernel picks a buffer for every chunk received
+            m_BufferRingMemory.Map(BufferCount * sizeof(io_uring_buf), MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            io_uring_buf_reg bufferRing = {};
+
+            bufferRing.ring_addr = reinterpret_cast<std::uintptr_t>(m_BufferRingMemory.Get<void>());
+            bufferRing.ring_entries = BufferCount;
+            bufferRing.bgid = BufferGroup;
+
+            if (syscall(__NR_io_uring_register, m_Ring.Get(), IORING_REGISTER_PBUF_RING, &bufferRing, 1) != 0)
+            {
+              ThrowTransportError("Unable to register io_uring buffer ring");
+            }
+
+            for (std::uint16_t buffer = 0; buffer < BufferCount; ++buffer)
+            {
+              RecycleBuffer(buffer);
+            }
+
+            AddInterruptListener();
+          }
+
+          virtual ~IoUringEngine() noexcept override
+          {
+            try
+            {
+              // buffers must not be released while the kernel may still receive into them
+              while (!m_Registrations.empty())
+              {
+                Remove(m_Registrations.begin()->first);
+              }
+
+              const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+              while ((m_PendingOperations > 0) && Wait(deadline));
+            }
+
+            catch (...)
+            {
+              // TODO: add trace / logging
+            }
+          }
+
+          virtual IoEngineType GetType() const override
+          {
+            return IoEngineType::IoUring;
+          }
+
+          virtual void AddListener(int socket, ReadyHandler handler) override
+          {
+            Arm(socket, Add(socket, std::make_shared<Registration>(Registration{0, std::move(handler), nullptr})));
+          }
+
+          virtual void AddReceiver(int socket, ReceiveHandler handler, FileHandler fileHandler) override
+          {
+            if (fileHandler)
+            {
+              // multishot receive does not support ancillary data, poll and read by recvmsg() instead
+              AddListener(socket, [this, socket, handler, fileHandler] { ReceiveAvailable(socket, m_PolledReceiveBuffer, handler, fileHandler); });
+
+              return;
+            }
+
+            Arm(socket, Add(socket, std::make_shared<Registration>(Registration{0, nullptr, std::move(handler)})));
+          }
+
+          virtual void Remove(int socket) override
+          {
+            const auto registration = m_Registrations.find(socket);
+
+            if (registration == m_Registrations.end())
+            {
+              return;
+            }
+
+            // completions still in flight are ignored from now on, see Complete()
+            io_uring_sqe& sqe = GetSqe();
+
+            sqe.opcode = IORING_OP_ASYNC_CANCEL;
+            sqe.addr = GetUserData(socket, *registration->second);
+            sqe.user_data = CancelUserData;
+
+            m_Registrations.erase(registration);
+          }
+
+          virtual bool Wait(std::chrono::steady_clock::time_point deadline) override
+          {
+            for (;;)
+            {
+              if (HandleCompletions())
+              {
+                // re-arming done by the handlers
+                Submit(false);
+
+                return !ConsumeInterrupt();
+              }
+
+              if (deadline == std::chrono::steady_clock::time_point::max())
+              {
+                Submit(true);
+
+                continue;
+              }
+
+              const auto now = std::chrono::steady_clock::now();
+
+              if (now >= deadline)
+              {
+                Submit(false);
+
+                return false;
+              }
+
+              const auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now);
+
+              __kernel_timespec timespec = {};
+
+              timespec.tv_sec = timeout.count() / 1000000000;
+              timespec.tv_nsec = timeout.count() % 1000000000;
+
+              // submits and waits with a single system call
+              Submit(true, &timespec);
+            }
+          }
+
+        private:
+          static const unsigned      RingEntries = 256;
+          static const std::uint16_t BufferCount = 64;  // power of two
+          static const std::uint16_t BufferGroup = 0;
+
+          static const std::uint64_t CancelUserData = ~std::uint64_t(0);
+
+          struct Registration
+          {
+            std::uint32_t  m_Id;  // distinguishes completions of a socket removed and added again
+            ReadyHandler   m_Ready;
+            ReceiveHandler m_Receive;
+          };
+
+          FileDescriptor m_Ring;
+          MemoryMapping  m_RingMemory;
+          MemoryMapping  m_SqeMemory;
+          MemoryMapping  m_BufferRingMemory;
+          Buffer         m_Buffers;
+          std::uint16_t  m_BufferRingTail;
+          Buffer         m_PolledReceiveBuffer;
+
+          std::uint32_t* m_SqHead = nullptr;
+          std::uint32_t* m_SqTailShared = nullptr;
+          std::uint32_t* m_SqArray = nullptr;
+          io_uring_sqe*  m_Sqes = nullptr;
+          std::uint32_t  m_SqMask = 0;
+          std::uint32_t  m_SqEntries = 0;
+          std::uint32_t  m_SqTail;              // published to the kernel by Submit()
+          std::uint32_t  m_PendingSubmissions;
+
+          std::uint32_t* m_CqHead = nullptr;
+          std::uint32_t* m_CqTail = nullptr;
+          io_uring_cqe*  m_Cqes = nullptr;
+          std::uint32_t  m_CqMask = 0;
+
+          std::size_t    m_PendingOperations;   // armed operations, each ends with a completion without IORING_CQE_F_MORE
+          std::uint32_t  m_NextId;
+
+          std::unordered_map<int, std::shared_ptr<Registration>> m_Registrations;
+
+          static std::uint64_t GetUserData(int socket, const Registration& registration)
+          {
+            return (static_cast<std::uint64_t>(registration.m_Id) << 32) | static_cast<std::uint32_t>(socket);
+          }
+
+          const Registration& Add(int socket, std::shared_ptr<Registration> registration)
+          {
+            assert(m_Registrations.find(socket) == m_Registrations.end());
+
+            registration->m_Id = m_NextId++;
+
+            return *(m_Registrations[socket] = std::move(registration));
+          }
+
+          // submits a multishot poll for listeners or a multishot receive
+          void Arm(int socket, const Registration& registration)
+          {
+            io_uring_sqe& sqe = GetSqe();
+
+            if (registration.m_Ready)
+            {
+              sqe.opcode = IORING_OP_POLL_ADD;
+              sqe.poll32_events = POLLIN;
+              sqe.len = IORING_POLL_ADD_MULTI;
+            }
+            else
+            {
+              sqe.opcode = IORING_OP_RECV;
+              sqe.ioprio = IORING_RECV_MULTISHOT;
+              sqe.flags = IOSQE_BUFFER_SELECT;
+              sqe.buf_group = BufferGroup;
+            }
+
+            sqe.fd = socket;
+            sqe.user_data = GetUserData(socket, registration);
+
+            ++m_PendingOperations;
+          }
+
+          io_uring_sqe& GetSqe()
+          {
+            // submission queue full, hand over to the kernel first
+            if ((m_SqTail - __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE)) == m_SqEntries)
+            {
+              Submit(false);
+            }
+
+            const std::uint32_t index = m_SqTail & m_SqMask;
+
+            io_uring_sqe& sqe = m_Sqes[index];
+
+            std::memset(&sqe, 0, sizeof(sqe));
+
+            m_SqArray[index] = index;
+
+            ++m_SqTail;
+            ++m_PendingSubmissions;
+
+            return sqe;
+          }
+
+          // submits pending entries, waits for at least one completion until timeout if given
+          // waits for a completion if wait is set, without timeout if timeout is nullptr
+          void Submit(bool wait, __kernel_timespec* timeout = nullptr)
+          {
+            if ((m_PendingSubmissions == 0) && !wait)
+            {
+              return;
+            }
+
+            __atomic_store_n(m_SqTailShared, m_SqTail, __ATOMIC_RELEASE);
+
+            io_uring_getevents_arg argument = {};
+
+            argument.sigmask_sz = _NSIG / 8;
+            argument.ts = reinterpret_cast<std::uintptr_t>(timeout);
+
+            const unsigned flags = wait ? (IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG) : 0;
+
+            const long result = syscall(__NR_io_uring_enter, m_Ring.Get(), m_PendingSubmissions, wait ? 1 : 0, flags,
+                                        wait ? &argument : nullptr, wait ? sizeof(argument) : 0);
+
+            if (result >= 0)
+            {
+              m_PendingSubmissions -= static_cast<std::uint32_t>(result);
+            }
+            else if ((errno != ETIME) && (errno != EINTR) && (errno != EBUSY) && (errno != EAGAIN))
+            {
+              ThrowTransportError("io_uring_enter failed");
+            }
+          }
+
+          // returns false if there were no completions
+          bool HandleCompletions()
+          {
+            std::uint32_t head = *m_CqHead;
+            const std::uint32_t tail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+
+            if (head == tail)
+            {
+              return false;
+            }
+
+            while (head != tail)
+            {
+              const io_uring_cqe completion = m_Cqes[head & m_CqMask];
+
+              // free the slot before calling handlers, they may submit new operations
+              __atomic_store_n(m_CqHead, ++head, __ATOMIC_RELEASE);
+
+              Complete(completion);
+            }
+
+            return true;
+          }
+
+          void Complete(const io_uring_cqe& completion)
+          {
+            if (completion.user_data == CancelUserData)
+            {
+              return;
+            }
+
+            const bool more = (completion.flags & IORING_CQE_F_MORE) != 0;
+
+            if (!more)
+            {
+              --m_PendingOperations;
+            }
+
+            const int socket = static_cast<int>(completion.user_data & 0xffffffff);
+
+            // ignore completions of removed sockets (but hand back their buffers)
+            const auto registration = m_Registrations.find(socket);
+
+            std::shared_ptr<Registration> current;
+
+            if ((registration != m_Registrations.end()) && (GetUserData(socket, *registration->second) == completion.user_data))
+            {
+              current = registration->second;
+            }
+
+            if ((completion.flags & IORING_CQE_F_BUFFER) != 0)
+            {
+              const std::uint16_t buffer = static_cast<std::uint16_t>(completion.flags >> IORING_CQE_BUFFER_SHIFT);
+
+              if (current && (completion.res > 0))
+              {
+                current->m_Receive(BufferView(&m_Buffers[buffer * ReceiveChunkSize], static_cast<std::size_t>(completion.res)));
+              }
+
+              RecycleBuffer(buffer);
+            }
+
+            if (!current)
+            {
+              return;
+            }
+
+            if (current->m_Ready)
+            {
+              if (completion.res > 0)
+              {
+                current->m_Ready();
+              }
+            }
+            else if ((completion.res == 0) || ((completion.res < 0) && (completion.res != -ENOBUFS) && (completion.res != -ECANCELED)))
+            {
+              // closed by peer or failed, the receive is not re-armed
+              current->m_Receive(BufferView());
+
+              return;
+            }
+
+            // multishot operation ended (e.g. out of buffers or canceled by the kernel as the submitting thread exited), re-arm unless removed by the handler
+            if (!more && (m_Registrations.find(socket) != m_Registrations.end()) && (m_Registrations[socket] == current))
+            {
+              Arm(socket, *current);
+            }
+          }
+
+          // hands buffer back to the kernel
+          void RecycleBuffer(std::uint16_t buffer)
+          {
+            io_uring_buf& entry = m_BufferRingMemory.Get<io_uring_buf>()[m_BufferRingTail & (BufferCount - 1)];
+
+            entry.addr = reinterpret_cast<std::uintptr_t>(&m_Buffers[buffer * ReceiveChunkSize]);
+            entry.len = ReceiveChunkSize;
+            entry.bid = buffer;
+
+            // tail overlays the reserved field of the first entry
+            __atomic_store_n(&m_BufferRingMemory.Get<io_uring_buf_ring>()->tail, ++m_BufferRingTail, __ATOMIC_RELEASE);
+          }
+      };
+
+#endif  // CPPRPC_HAS_IO_URING
+
+    }  // anonymous namespace
+
+
+    namespace Detail
+    {
+
+      std::unique_ptr<IoEngine> MakeIoEngine(IoEngineType type)
+      {
+        switch (type)
+        {
+          case IoEngineType::Automatic:
+#ifdef CPPRPC_HAS_IO_URING
+            try
+            {
+              return std::unique_ptr<IoEngine>(new IoUringEngine());
+            }
+
+            catch (const TransportError&)
+            {
+              // not supported (old kernel, disabled by seccomp, ...), fall back to epoll
+            }
+#endif
+            return std::unique_ptr<IoEngine>(new EpollEngine());
+
+          case IoEngineType::Epoll:
+            return std::unique_ptr<IoEngine>(new EpollEngine());
+
+          case IoEngineType::IoUring:
+#ifdef CPPRPC_HAS_IO_URING
+            return std::unique_ptr<IoEngine>(new IoUringEngine());
+#else
+            throw ExceptionImpl<TransportError>("io_uring not supported by this build");
+#endif
+
+          default:
+            throw ExceptionImpl<TransportError>("Unknown I/O engine type");
+        }
+      }
+
+    }  // namespace Detail
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
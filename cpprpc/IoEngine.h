@@ -0,0 +1,118 @@
+#ifndef CPPRPC_IOENGINE_H
+#define CPPRPC_IOENGINE_H
+
+#pragma once
+
+// I/O engines are built on epoll and io_uring, Linux only for now
+#if defined(__linux__)
+
+#include <string>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <cerrno>
+
+#include <boost/noncopyable.hpp>
+
+#include "cpprpc/Types.h"
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    enum class IoEngineType
+    {
+      Automatic,  // io_uring if supported by the kernel, epoll otherwise
+      Epoll,
+      IoUring
+    };
+
+    namespace Detail
+    {
+
+      // owns a file descriptor
+      class FileDescriptor : boost::noncopyable
+      {
+        public:
+          explicit FileDescriptor(int fd = -1)
+          : m_Fd(fd)
+          {}
+
+          ~FileDescriptor();
+
+          int Get() const { return m_Fd; }
+
+          void Reset(int fd = -1);
+
+          // gives up ownership without closing
+          int Release()
+          {
+            const int fd = m_Fd;
+
+            m_Fd = -1;
+
+            return fd;
+          }
+
+        private:
+          int m_Fd;
+      };
+
+      // throws TransportError, what is followed by the description of error
+      [[noreturn]] void ThrowTransportError(const std::string& what, int error = errno);
+
+
+      // waits for and receives data from non-blocking sockets, used by a single thread only
+      class IoEngine : boost::noncopyable
+      {
+        public:
+          // called for every chunk of data received, an empty view signals the socket was closed (by the peer or due to an error)
+          using ReceiveHandler = std::function<void(BufferView data)>;
+
+          // called for every file descriptor received (SCM_RIGHTS) before the data it was sent with, takes ownership
+          using FileHandler = std::function<void(int file)>;
+
+          // called if a listening socket is readable (has pending connections)
+          using ReadyHandler = std::function<void()>;
+
+          virtual ~IoEngine() noexcept = default;
+
+          virtual IoEngineType GetType() const = 0;
+
+          // handlers are only called from Wait(), sockets must stay open until removed, may be called from within a handler
+          virtual void AddListener(int socket, ReadyHandler handler) = 0;
+          virtual void AddReceiver(int socket, ReceiveHandler handler, FileHandler fileHandler = nullptr) = 0;  // sockets with a file handler are read by recvmsg()
+          virtual void Remove(int socket) = 0;
+
+          // handles all events available until deadline (time_point::max() waits without timeout), returns false if there were none or if interrupted
+          virtual bool Wait(std::chrono::steady_clock::time_point deadline) = 0;
+
+          // thread safe, makes the current Wait() (or the next one, if none is running) return false
+          void Interrupt();
+
+        protected:
+          IoEngine();
+
+          // registers the interrupt event, called by the constructor of the engine
+          void AddInterruptListener();
+
+          // true if Interrupt() was called, once per call, used by Wait() of the engines
+          bool ConsumeInterrupt();
+
+        private:
+          FileDescriptor m_InterruptEvent;  // eventfd
+          bool           m_Interrupted;     // event seen by the listener, reset by ConsumeInterrupt()
+      };
+
+      // throws TransportError if the requested engine is not supported
+      std::unique_ptr<IoEngine> MakeIoEngine(IoEngineType type);
+
+    }  // namespace Detail
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
+
+#endif
@@ -3,8 +3,14 @@
 
 #pragma once
 
-#include <sstream>
 #include <type_traits>
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <typeinfo>
+#include <cstdint>
 #include <cassert>
 
 #include <boost/mpl/size.hpp>
@@ -12,45 +18,114 @@
 #include <boost/mpl/back.hpp>
 #include <boost/mpl/pop_front.hpp>
 #include <boost/mpl/pop_back.hpp>
-#include <boost/variant/variant.hpp>
-
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/archive/text_iarchive.hpp>
+#include <boost/mpl/at.hpp>
+#include <boost/mpl/fold.hpp>
+#include <boost/mpl/placeholders.hpp>
 #include <boost/serialization/version.hpp>
-#pragma warning(push)
-#pragma warning(disable: 4100)  // boost/serialization/collections_load_imp.hpp(67): warning C4100: 'item_version': unreferenced formal parameter
-#include <boost/serialization/vector.hpp>
-#pragma warning(pop)
-#include <boost/serialization/variant.hpp>
+#include <boost/format.hpp>
 
 #include "cpprpc/Types.h"
-#include "cpprpc/Dispatcher.h"
 #include "cpprpc/Exception.h"
+#include "cpprpc/ArgumentArena.h"
+#include "cpprpc/BinarySerializer.h"
+#include "cpprpc/TextSerializer.h"
 
 
 namespace CppRpc
 {
   inline namespace V1
   {
+    template <InterfaceMode Mode, template <InterfaceMode> class Dispatcher>
+    class Interface;
+
     namespace Detail
     {
 
+      // every message starts with the library version followed by the message type, both encoded as single byte,
+      // and the correlation id (fixed width) of the call
+      enum class MessageType : std::uint8_t
+      {
+        ResolveFunction = 1,  // client -> server: FunctionIdentity, answered with the FunctionId (or an error)
+        FunctionCall    = 2,  // client -> server: FunctionId + parameters, answered with the result (see ResultTag)
+        Result          = 3,  // server -> client: result of the call with the same correlation id
+        Batch           = 4,  // client -> server: sequence of size prefixed (fixed width) messages, answered with a BatchResult
+        BatchResult     = 5,  // server -> client: sequence of size prefixed (fixed width) results of the calls in a Batch
+        OneWayCall      = 6,  // client -> server: FunctionId + parameters, never answered
+      };
+
+      // ties a result to its call, assigned by the client dispatcher for every call
+      using CorrelationId = std::uint32_t;
+
+      const CorrelationId NoCorrelationId = 0;  // used for messages not (yet) assigned to a call
+
+      // offset of the correlation id in every message, see Marshaller::SetCorrelationId()
+      const std::size_t CorrelationIdOffset = 2 * sizeof(std::uint8_t);
+
+      // message headers are always encoded fixed width
+      const std::size_t MessageHeaderSize = CorrelationIdOffset + sizeof(CorrelationId);
+
+      // size of a message in a batch, fixed width to allow writing the message before its size is known
+      using BatchMessageSize = std::uint32_t;
+
+      // compact function identifier, assigned by the server dispatcher and resolved once per function by the client
+      using FunctionId = std::uint32_t;
+
+      const FunctionId InvalidFunctionId = ~FunctionId(0);
+
+      // identifies a function across the wire, only sent to resolve its FunctionId
+      struct FunctionIdentity
+      {
+        Name    m_InterfaceName;
+        Version m_InterfaceVersion;
+        Name    m_FunctionName;
+
+        bool operator<(const FunctionIdentity& other) const
+        {
+          return std::tie(m_InterfaceName, m_InterfaceVersion, m_FunctionName) < std::tie(other.m_InterfaceName, other.m_InterfaceVersion, other.m_FunctionName);
+        }
+      };
+
       template<class Archive>
-      inline void serialize(Archive& ar, RemoteFunctionCall& funcDispHeader, const unsigned int version)
+      inline void serialize(Archive& ar, FunctionIdentity& functionIdentity, const unsigned int version)
       {
         if (version == LibraryVersionV1)
         {
-          ar & funcDispHeader.m_InterfaceName;
-          ar & funcDispHeader.m_InterfaceVersion;
-          ar & funcDispHeader.m_FunctionName;
-          ar & funcDispHeader.m_ParameterData;
+          ar & functionIdentity.m_InterfaceName;
+          ar & functionIdentity.m_InterfaceVersion;
+          ar & functionIdentity.m_FunctionName;
         }
         else
         {
-          throw Detail::ExceptionImpl<LibraryVersionMissmatch>("Version of class RemoteFunctionCall not equal to expected library version");
+          throw Detail::ExceptionImpl<LibraryVersionMissmatch>("Version of class FunctionIdentity not equal to expected library version");
         }
       }
 
+      // header of a received message
+      struct MessageHeader
+      {
+        MessageType   m_Type;
+        CorrelationId m_CorrelationId;
+        BufferView    m_Payload;  // refers to the data the header was de-serialized from
+      };
+
+      // received result message (client side), header already checked by the dispatcher
+      struct ResultMessage
+      {
+        Buffer      m_Data;
+        BufferSlice m_Shared;  // used instead of m_Data for results of a batch, shares the data of the whole batch result
+
+        BufferView GetPayload() const
+        {
+          return (m_Shared.empty() ? BufferView(m_Data) : BufferView(m_Shared)).subview(MessageHeaderSize);
+        }
+      };
+
+      // de-serialized function call (server side), the parameters are encoded using the selected serializer
+      struct RemoteFunctionCall
+      {
+        FunctionId m_FunctionId;
+        BufferView m_ParameterData;  // refers to the data the call was de-serialized from
+      };
 
       struct RemoteExceptionData
       {
@@ -73,20 +148,32 @@ namespace CppRpc
       }
 
 
-      template <typename ReturnType>
-      struct RemoteCallResultHelper
+      // results start with a tag byte, followed by the return value (nothing for void) or the RemoteExceptionData
+      enum class ResultTag : std::uint8_t
       {
-        using Type = boost::variant<ReturnType, RemoteExceptionData>;
+        ReturnValue = 0,
+        Exception   = 1,
       };
 
-      template <>
-      struct RemoteCallResultHelper<void>
+      // std::tuple of the (unqualified) parameter types of an MPL sequence, holds the de-serialized arguments of a call
+      template <typename Tuple, typename T>
+      struct AppendArgument;
+
+      template <typename... Arguments, typename T>
+      struct AppendArgument<std::tuple<Arguments...>, T>
       {
-        using Type = boost::variant<bool, RemoteExceptionData>;
+        using type = std::tuple<Arguments..., std::remove_cv_t<std::remove_reference_t<T>>>;
       };
 
-      template <typename ReturnType>
-      using RemoteCallResult = typename RemoteCallResultHelper<ReturnType>::Type;
+      template <typename ParameterTypes>
+      using ArgumentTuple = typename boost::mpl::fold<ParameterTypes, std::tuple<>, AppendArgument<boost::mpl::_1, boost::mpl::_2>>::type;
+
+      // de-serialized arguments are moved into parameters taken by value or rvalue reference, lvalue references refer to the argument itself
+      template <typename Parameter, typename T>
+      std::conditional_t<std::is_lvalue_reference<Parameter>::value, T&, T&&> ForwardArgument(T& argument)
+      {
+        return static_cast<std::conditional_t<std::is_lvalue_reference<Parameter>::value, T&, T&&>>(argument);
+      }
 
     }  // namespace Detail
 
@@ -105,29 +192,81 @@ namespace CppRpc
     }
 
 
-    // TODO: extract de-/serializer into (template) parameter
-    template <template <InterfaceMode> class Dispatcher>
+#ifdef CPPRPC_USE_TEXT_SERIALIZER
+    using DefaultSerializer = TextSerializer;  // for debugging only, client and server need to agree on the serializer!
+#else
+    using DefaultSerializer = BinarySerializer;
+#endif
+
+    // Serializer needs to provide the archive types OArchive (appends to a Buffer) and IArchive (reads directly from a BufferView)
+    template <template <InterfaceMode> class Dispatcher, typename Serializer = DefaultSerializer>
     class Marshaller
     {
       private:
-        using OStream = std::ostringstream;
-        using OArchive = boost::archive::text_oarchive;
-
-        using IStream = std::istringstream;
-        using IArchive = boost::archive::text_iarchive;
+        using OArchive = typename Serializer::OArchive;
+        using IArchive = typename Serializer::IArchive;
 
       public:
 
-        template <typename ArgumentTypes, InterfaceMode Mode, typename... Arguments>
-        static Buffer SerializeFunctionCall(const Interface<Mode, Dispatcher>& interface, const Name& functionName, Arguments&&... arguments);
+        // client side, all messages are serialized with NoCorrelationId, the dispatcher sets the actual one before sending
+
+        template <InterfaceMode Mode>
+        static Buffer SerializeResolveFunction(const Interface<Mode, Dispatcher>& interface, const Name& functionName);
+
+        // throws UnknownFunction if the server does not know the function
+        static Detail::FunctionId DeserializeResolveFunctionResult(BufferView data);
 
+        // pre-encodes the call header (library version, message type, function id), done once per function
+        static Buffer SerializeFunctionCallHeader(Detail::FunctionId functionId, bool oneWay = false);
+
+        // copies the pre-encoded call header into callData (an empty buffer, e.g. from Transport::Acquire()) and appends the arguments,
+        // no further allocation if sizeHint is big enough
+        template <typename ArgumentTypes, typename... Arguments>
+        static Buffer SerializeFunctionCall(Buffer callData, const Buffer& callHeader, std::size_t sizeHint, Arguments&&... arguments);
+
+        // returns the return value of a call, throws UnknowRemoteException if the server reported an exception
         template <typename ReturnType>
-        static ReturnType DeserializeReturnValue(const Buffer& buffer);
+        static ReturnType DeserializeResult(BufferView data);
+
+        // overwrites the correlation id of an already serialized message in place
+        static void SetCorrelationId(Buffer& message, Detail::CorrelationId correlationId);
+
+        // client and server side, all returned headers refer to data, data needs to outlive them
+        static Detail::MessageHeader DeserializeMessageHeader(BufferView data);
+
+        // batches (MessageType::Batch or MessageType::BatchResult) are built by appending complete messages to the batch header
+        static void SerializeBatchHeader(Buffer& batchData, Detail::MessageType batchType);
+        static void AppendBatchMessage(Buffer& batchData, BufferView message);
+
+        // alternative to AppendBatchMessage(), the message is appended to batchData in between, returns offset of the message size
+        static std::size_t BeginBatchMessage(Buffer& batchData);
+        static void EndBatchMessage(Buffer& batchData, std::size_t sizeOffset);
 
-        static Detail::RemoteFunctionCall DeserializeFunctionDispatchHeader(const Buffer& data);
+        // returned messages refer to payload
+        static std::vector<BufferView> DeserializeBatch(BufferView payload);
 
+        // server side, results are appended to resultData, starting with the result header
+
+        static void SerializeResultHeader(Buffer& resultData, Detail::CorrelationId correlationId);
+
+        static Detail::FunctionIdentity DeserializeResolveFunction(BufferView payload);
+
+        static void SerializeResolveFunctionResult(Buffer& resultData, Detail::FunctionId functionId, const Detail::FunctionIdentity& functionIdentity);
+
+        // for FunctionCall and OneWayCall messages
+        static Detail::RemoteFunctionCall DeserializeFunctionCall(BufferView payload);
+
+        // parameters taking a std::pmr::polymorphic_allocator (C++17) are allocated from a per call arena (see Detail::ArgumentArena),
+        // implementations must not move from them or keep references beyond the call
         template <typename ReturnType, typename ArgumentTypes, typename Implementaion>
-        static Buffer DeserializeAndExecuteFunctionCall(const Buffer& paramData, Implementaion& implementation);
+        static void DeserializeAndExecuteFunctionCall(BufferView paramData, Buffer& resultData, Implementaion& implementation);
+
+        // no result is serialized, exceptions thrown by the implementation are passed on to the caller
+        template <typename ArgumentTypes, typename Implementaion>
+        static void DeserializeAndExecuteOneWayFunctionCall(BufferView paramData, Implementaion& implementation);
+
+        // result for a failed call, valid for any return type
+        static void SerializeErrorResult(Buffer& resultData, const Detail::RemoteExceptionData& exceptionData);
 
       private:
 
@@ -139,71 +278,48 @@ namespace CppRpc
         static void SerializeArguments(OArchive& /*archive*/);
 
 
-        template <typename ReturnType, typename ArgumentTypes, 
-                  typename RemoteCallResult = Detail::RemoteCallResult<ReturnType>, std::size_t ArgumentCount = boost::mpl::size<ArgumentTypes>::value>
-        struct FunctionCallHelper
+        // arguments are de-serialized in place into the tuple (allocator aware ones into the argument arena of the call, see Detail::ArgumentArena)
+        template <typename Arguments, std::size_t... Indices>
+        static Arguments MakeArguments(std::index_sequence<Indices...>)
         {
-          static_assert(boost::mpl::size<ArgumentTypes>::value > 0, "");
+          return Arguments{Detail::MakeArgument<std::tuple_element_t<Indices, Arguments>>()...};
+        }
 
-          template <typename Implementaion, typename... Arguments>
-          void operator()(IArchive& iarchive, OArchive& oarchive, Implementaion& implementation, Arguments&&... arguments)
-          {
-            using ParameterType = std::remove_reference_t<boost::mpl::front<ArgumentTypes>::type>;
+        template <typename Arguments, std::size_t... Indices>
+        static void DeserializeArguments(IArchive& archive, Arguments& arguments, std::index_sequence<Indices...>)
+        {
+          // use initializer list to guarantee left to right evaluation
+          const int dummy[] = {0, (archive >> std::get<Indices>(arguments), 0)...};
+          (void) dummy;
+        }
 
-            // deserialize parameter
-            ParameterType param = Deserialize<std::remove_const_t<ParameterType>>(iarchive);
+        template <typename ArgumentTypes, typename Implementaion, typename Arguments, std::size_t... Indices>
+        static decltype(auto) CallImplementation(Implementaion& implementation, Arguments& arguments, std::index_sequence<Indices...>)
+        {
+          return implementation(Detail::ForwardArgument<typename boost::mpl::at_c<ArgumentTypes, Indices>::type>(std::get<Indices>(arguments))...);
+        }
 
-            // deserialize remaining parameters OR do function call
-            FunctionCallHelper<ReturnType, boost::mpl::pop_front<ArgumentTypes>::type>()(iarchive, oarchive, implementation, std::forward<Arguments>(arguments)..., param);
-          }
-        };
+        // the return value is serialized straight from the temporary returned by the implementation, it is never copied
+        template <typename ReturnType, typename ArgumentTypes, typename Implementaion, typename Arguments, typename Indices>
+        static void ExecuteFunctionCall(OArchive& oarchive, Implementaion& implementation, Arguments& arguments, Indices indices, std::false_type /*returnsVoid*/)
+        {
+          SerializeReturnValue<ReturnType>(oarchive, CallImplementation<ArgumentTypes>(implementation, arguments, indices));
+        }
 
-        // spezialisation for ReturnType != void AND no more parameters
-        template <typename ReturnType, typename ArgumentTypes, typename RemoteCallResult>
-        struct FunctionCallHelper<ReturnType, ArgumentTypes, RemoteCallResult, 0>
+        template <typename ReturnType, typename ArgumentTypes, typename Implementaion, typename Arguments, typename Indices>
+        static void ExecuteFunctionCall(OArchive& oarchive, Implementaion& implementation, Arguments& arguments, Indices indices, std::true_type /*returnsVoid*/)
         {
-          static_assert(boost::mpl::size<ArgumentTypes>::value == 0, "");
-          static_assert(!std::is_void<ReturnType>::value, "");
+          CallImplementation<ArgumentTypes>(implementation, arguments, indices);
 
-          template <typename Implementaion, typename... Arguments>
-          void operator()(IArchive& /*archive*/, OArchive& oarchive, Implementaion& implementation, Arguments&&... arguments)
-          {
-            try
-            {
-              // TODO: try to seperate exception thrown by implementation (+ argument passing) and exception from serialization code?
-              // call function implementation AND serialize result (avoid named temporary instance of ReturnType!)
-              Serialize<RemoteCallResult>(oarchive, implementation(std::forward<Arguments>(arguments)...));
-            }
-            catch (...)
-            {              
-              HandleException<RemoteCallResult>(oarchive);
-            }            
-          }
-        };
+          oarchive << Detail::ResultTag::ReturnValue;
+        }
 
-        // spezialisation for ReturnType == void AND no more parameters
-        template <typename ArgumentTypes, typename RemoteCallResult>
-        struct FunctionCallHelper<void, ArgumentTypes, RemoteCallResult, 0>
+        template <typename ReturnType>
+        static void SerializeReturnValue(OArchive& oarchive, const ReturnType& returnValue)
         {
-          static_assert(boost::mpl::size<ArgumentTypes>::value == 0, "");
-
-          template <typename Implementaion, typename... Arguments>
-          void operator()(IArchive& /*archive*/, OArchive& oarchive, Implementaion& implementation, Arguments&&... arguments)
-          {
-            // call function implementation
-            try
-            {
-              implementation(std::forward<Arguments>(arguments)...);
-              Serialize<RemoteCallResult>(oarchive, RemoteCallResult());
-            }
-            catch (...)
-            {
-              HandleException<RemoteCallResult>(oarchive);              
-            }
-          }
-        };
+          oarchive << Detail::ResultTag::ReturnValue << returnValue;
+        }
 
-        template <typename RemoteCallResult>
         static void HandleException(OArchive& oarchive)
         {
           try
@@ -214,12 +330,41 @@ namespace CppRpc
           catch (const std::exception& e)
           {
             // TODO: add support for serialization of registred exception types
-            Serialize<RemoteCallResult>(oarchive, Detail::RemoteExceptionData({typeid(e).name(), e.what()}));
+            oarchive << Detail::ResultTag::Exception << Detail::RemoteExceptionData({typeid(e).name(), e.what()});
           }
 
           catch (...)
           {
-            Serialize<RemoteCallResult>(oarchive, Detail::RemoteExceptionData({"Unknown exception type", ""}));
+            oarchive << Detail::ResultTag::Exception << Detail::RemoteExceptionData({"Unknown exception type", ""});
+          }
+        }
+
+        // returns true if a return value follows, false for RemoteExceptionData
+        template <typename Archive>
+        static bool DeserializeResultTag(Archive& archive)
+        {
+          Detail::ResultTag tag = Detail::ResultTag::Exception;
+          archive >> tag;
+
+          if ((tag != Detail::ResultTag::ReturnValue) && (tag != Detail::ResultTag::Exception))
+          {
+            throw Detail::ExceptionImpl<MalformedMessage>((boost::format("Invalid result tag %1%") % static_cast<unsigned>(tag)).str());
+          }
+
+          return tag == Detail::ResultTag::ReturnValue;
+        }
+
+        // overwrites already serialized data, fixed width little endian (same as written by Detail::BinaryOArchive)
+        template <typename T>
+        static void WriteFixedWidth(Buffer& data, std::size_t offset, T value)
+        {
+          static_assert(std::is_unsigned<T>::value, "");
+
+          assert(data.size() >= offset + sizeof(value));
+
+          for (std::size_t i = 0; i < sizeof(value); ++i)
+          {
+            data[offset + i] = static_cast<Byte>(value >> (8 * i));
           }
         }
 
@@ -236,12 +381,13 @@ namespace CppRpc
           return DeserializeHelper<T>::Deserialize(archive);
         }
 
-        template <typename T>
+        template <typename T, typename Dummy = void>
         struct DeserializeHelper
         {
           static T Deserialize(IArchive& archive)
           {
-            T t;
+            // allocator aware parameters are constructed in the argument arena of the call (if any), see Detail::ArgumentArena
+            T t = Detail::MakeArgument<T>();
 
             archive >> t;
 
@@ -250,8 +396,8 @@ namespace CppRpc
         };
 
         // spezialisation for T = void
-        template <>
-        struct DeserializeHelper<void>
+        template <typename Dummy>
+        struct DeserializeHelper<void, Dummy>
         {
           static void Deserialize(IArchive& /*archive*/)
           {}
@@ -259,78 +405,296 @@ namespace CppRpc
 
     };  // class Marshaller
 
-    template <template <InterfaceMode> class Dispatcher>
-    template <typename ArgumentTypes, InterfaceMode Mode, typename... Arguments>
-    Buffer Marshaller<Dispatcher>::SerializeFunctionCall(const Interface<Mode, Dispatcher>& interface, const Name& functionName, Arguments&&... arguments)
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    template <InterfaceMode Mode>
+    Buffer Marshaller<Dispatcher, Serializer>::SerializeResolveFunction(const Interface<Mode, Dispatcher>& interface, const Name& functionName)
+    {
+      Buffer data;
+
+      Detail::BinaryOArchive archive(data);
+
+      archive << LibraryVersion << Detail::MessageType::ResolveFunction << Detail::NoCorrelationId << Detail::FunctionIdentity{interface.GetName(), interface.GetVersion(), functionName};
+
+      return data;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    Detail::FunctionId Marshaller<Dispatcher, Serializer>::DeserializeResolveFunctionResult(BufferView data)
+    {
+      Detail::BinaryIArchive archive(data);
+
+      if (!DeserializeResultTag(archive))
+      {
+        Detail::RemoteExceptionData exceptionData;
+        archive >> exceptionData;
+
+        throw Detail::ExceptionImpl<UnknownFunction>(exceptionData.m_What);
+      }
+
+      Detail::FunctionId functionId = Detail::InvalidFunctionId;
+      archive >> functionId;
+
+      return functionId;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    Buffer Marshaller<Dispatcher, Serializer>::SerializeFunctionCallHeader(Detail::FunctionId functionId, bool oneWay)
+    {
+      Buffer callHeader;
+
+      Detail::BinaryOArchive archive(callHeader);
+
+      archive << LibraryVersion << (oneWay ? Detail::MessageType::OneWayCall : Detail::MessageType::FunctionCall) << Detail::NoCorrelationId << functionId;
+
+      return callHeader;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    template <typename ArgumentTypes, typename... Arguments>
+    Buffer Marshaller<Dispatcher, Serializer>::SerializeFunctionCall(Buffer callData, const Buffer& callHeader, std::size_t sizeHint, Arguments&&... arguments)
     {
       // check number of arguments (ArgumentTypes vs Arguments)
       static_assert(boost::mpl::size<ArgumentTypes>::value == sizeof...(arguments), "invalid number of arguments supplied");
 
-      OStream stream;
+      callData.reserve(std::max(sizeHint, callHeader.size()));
+      callData.assign(callHeader.begin(), callHeader.end());
 
       {
-        OArchive archive(stream);
+        OArchive archive(callData);
 
         // serialize arguments
         SerializeArguments<ArgumentTypes>(archive, std::forward<Arguments>(arguments)...);
       }
 
-      auto str = stream.str();
+      return callData;
+    }
 
-      // reset output stream
-      stream = OStream();
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    template <typename ReturnType>
+    ReturnType Marshaller<Dispatcher, Serializer>::DeserializeResult(BufferView data)
+    {
+      IArchive archive(data);
 
+      if (!DeserializeResultTag(archive))
       {
-        OArchive archive(stream);
+        Detail::RemoteExceptionData exceptionData;
+        archive >> exceptionData;
 
-        // serialize function call
-        Serialize(archive, Dispatcher<Mode>::RemoteFunctionCall(interface, functionName, Buffer(str.data(), str.data() + str.size())));
+        // TODO: add handling for registred exception types
+        throw Detail::ExceptionImpl<UnknowRemoteException>((boost::format("Exception type: \"%1%\", what: \"%2%\"") % exceptionData.m_Name % exceptionData.m_What).str());
       }
 
-      str = stream.str();
-      return Buffer(str.data(), str.data() + str.size());
+      return Deserialize<ReturnType>(archive);
     }
 
-    template <template <InterfaceMode> class Dispatcher>
-    template <typename ReturnType>
-    ReturnType Marshaller<Dispatcher>::DeserializeReturnValue(const Buffer& buffer)
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    void Marshaller<Dispatcher, Serializer>::SetCorrelationId(Buffer& message, Detail::CorrelationId correlationId)
     {
-      IStream stream(std::string(buffer.begin(), buffer.end()));
-      IArchive archive(stream);
+      assert(message.size() >= Detail::CorrelationIdOffset + sizeof(correlationId));
 
-      return Deserialize<ReturnType>(archive);
+      WriteFixedWidth(message, Detail::CorrelationIdOffset, correlationId);
     }
 
-    template <template <InterfaceMode> class Dispatcher>
-    Detail::RemoteFunctionCall Marshaller<Dispatcher>::DeserializeFunctionDispatchHeader(const Buffer& data)
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    Detail::MessageHeader Marshaller<Dispatcher, Serializer>::DeserializeMessageHeader(BufferView data)
     {
-      IStream stream(std::string(data.begin(), data.end()));
-      IArchive archive(stream);
+      Detail::BinaryIArchive archive(data);
+
+      std::uint8_t libraryVersion = 0;
+      archive >> libraryVersion;
+
+      if (libraryVersion != LibraryVersion)
+      {
+        throw Detail::ExceptionImpl<LibraryVersionMissmatch>((boost::format("Library version of message (%1%) not equal to expected library version (%2%)") % static_cast<unsigned>(libraryVersion) % static_cast<unsigned>(LibraryVersion)).str());
+      }
 
-      return Deserialize<Detail::RemoteFunctionCall>(archive);
+      Detail::MessageHeader header;
+      archive >> header.m_Type >> header.m_CorrelationId;
+
+      // payload follows directly after the header
+      header.m_Payload = data.subview(data.size() - archive.GetRemainingSize());
+
+      return header;
     }
 
-    template <template <InterfaceMode> class Dispatcher>
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    void Marshaller<Dispatcher, Serializer>::SerializeBatchHeader(Buffer& batchData, Detail::MessageType batchType)
+    {
+      assert((batchType == Detail::MessageType::Batch) || (batchType == Detail::MessageType::BatchResult));
+
+      Detail::BinaryOArchive archive(batchData);
+
+      // every message in the batch has its own correlation id
+      archive << LibraryVersion << batchType << Detail::NoCorrelationId;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    void Marshaller<Dispatcher, Serializer>::AppendBatchMessage(Buffer& batchData, BufferView message)
+    {
+      const std::size_t sizeOffset = BeginBatchMessage(batchData);
+
+      batchData.insert(batchData.end(), message.begin(), message.end());
+
+      EndBatchMessage(batchData, sizeOffset);
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    std::size_t Marshaller<Dispatcher, Serializer>::BeginBatchMessage(Buffer& batchData)
+    {
+      const std::size_t sizeOffset = batchData.size();
+
+      // placeholder, see EndBatchMessage()
+      batchData.resize(sizeOffset + sizeof(Detail::BatchMessageSize));
+
+      return sizeOffset;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    void Marshaller<Dispatcher, Serializer>::EndBatchMessage(Buffer& batchData, std::size_t sizeOffset)
+    {
+      const std::size_t size = batchData.size() - sizeOffset - sizeof(Detail::BatchMessageSize);
+
+      assert(size <= std::numeric_limits<Detail::BatchMessageSize>::max());
+
+      WriteFixedWidth(batchData, sizeOffset, static_cast<Detail::BatchMessageSize>(size));
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    std::vector<BufferView> Marshaller<Dispatcher, Serializer>::DeserializeBatch(BufferView payload)
+    {
+      std::vector<BufferView> messages;
+
+      while (!payload.empty())
+      {
+        Detail::BinaryIArchive archive(payload);
+
+        Detail::BatchMessageSize size = 0;
+        archive >> size;
+
+        const BufferView message = payload.subview(payload.size() - archive.GetRemainingSize());
+
+        if (size > message.size())
+        {
+          throw Detail::ExceptionImpl<MalformedMessage>((boost::format("Batch message size %1% exceeds remaining data") % size).str());
+        }
+
+        messages.emplace_back(message.data(), size);
+
+        payload = message.subview(size);
+      }
+
+      return messages;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    void Marshaller<Dispatcher, Serializer>::SerializeResultHeader(Buffer& resultData, Detail::CorrelationId correlationId)
+    {
+      Detail::BinaryOArchive archive(resultData);
+
+      archive << LibraryVersion << Detail::MessageType::Result << correlationId;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    Detail::FunctionIdentity Marshaller<Dispatcher, Serializer>::DeserializeResolveFunction(BufferView payload)
+    {
+      Detail::BinaryIArchive archive(payload);
+
+      Detail::FunctionIdentity functionIdentity;
+      archive >> functionIdentity;
+
+      return functionIdentity;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    void Marshaller<Dispatcher, Serializer>::SerializeResolveFunctionResult(Buffer& resultData, Detail::FunctionId functionId, const Detail::FunctionIdentity& functionIdentity)
+    {
+      Detail::BinaryOArchive archive(resultData);
+
+      if (functionId != Detail::InvalidFunctionId)
+      {
+        archive << Detail::ResultTag::ReturnValue << functionId;
+      }
+      else
+      {
+        const auto what = (boost::format("Unknown Function \"%1%:%2%::%3%\"") % functionIdentity.m_InterfaceName % functionIdentity.m_InterfaceVersion.str() % functionIdentity.m_FunctionName).str();
+
+        archive << Detail::ResultTag::Exception << Detail::RemoteExceptionData({typeid(UnknownFunction).name(), what});
+      }
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    Detail::RemoteFunctionCall Marshaller<Dispatcher, Serializer>::DeserializeFunctionCall(BufferView payload)
+    {
+      Detail::BinaryIArchive archive(payload);
+
+      Detail::RemoteFunctionCall functionCall;
+      archive >> functionCall.m_FunctionId;
+
+      // parameters follow directly after the function id
+      functionCall.m_ParameterData = payload.subview(payload.size() - archive.GetRemainingSize());
+
+      return functionCall;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
     template <typename ReturnType, typename ArgumentTypes, typename Implementaion>
-    Buffer Marshaller<Dispatcher>::DeserializeAndExecuteFunctionCall(const Buffer& paramData, Implementaion& implementation)
+    void Marshaller<Dispatcher, Serializer>::DeserializeAndExecuteFunctionCall(BufferView paramData, Buffer& resultData, Implementaion& implementation)
     {
-      IStream istream(std::string(paramData.begin(), paramData.end()));
-      IArchive iarchive(istream);
+      // released after the result was serialized
+      const Detail::ArgumentArenaScope<Detail::AnyUsesArgumentArena<ArgumentTypes>::value> arena;
+
+      using Arguments = Detail::ArgumentTuple<ArgumentTypes>;
+      using Indices = std::make_index_sequence<std::tuple_size<Arguments>::value>;
+
+      Arguments arguments = MakeArguments<Arguments>(Indices());
 
-      OStream ostream;
-      OArchive oarchive(ostream);
+      IArchive iarchive(paramData);
+      DeserializeArguments(iarchive, arguments, Indices());
 
-      FunctionCallHelper<ReturnType, ArgumentTypes>()(iarchive, oarchive, implementation);
+      OArchive oarchive(resultData);
 
-      auto str = ostream.str();
-      return Buffer(str.data(), str.data() + str.size());
+      try
+      {
+        // TODO: try to seperate exception thrown by implementation (+ argument passing) and exception from serialization code?
+        ExecuteFunctionCall<ReturnType, ArgumentTypes>(oarchive, implementation, arguments, Indices(), std::is_void<ReturnType>());
+      }
+
+      catch (...)
+      {
+        HandleException(oarchive);
+      }
     }
 
-    template <template <InterfaceMode> class Dispatcher>
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    template <typename ArgumentTypes, typename Implementaion>
+    void Marshaller<Dispatcher, Serializer>::DeserializeAndExecuteOneWayFunctionCall(BufferView paramData, Implementaion& implementation)
+    {
+      const Detail::ArgumentArenaScope<Detail::AnyUsesArgumentArena<ArgumentTypes>::value> arena;
+
+      using Arguments = Detail::ArgumentTuple<ArgumentTypes>;
+      using Indices = std::make_index_sequence<std::tuple_size<Arguments>::value>;
+
+      Arguments arguments = MakeArguments<Arguments>(Indices());
+
+      IArchive iarchive(paramData);
+      DeserializeArguments(iarchive, arguments, Indices());
+
+      CallImplementation<ArgumentTypes>(implementation, arguments, Indices());
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
+    void Marshaller<Dispatcher, Serializer>::SerializeErrorResult(Buffer& resultData, const Detail::RemoteExceptionData& exceptionData)
+    {
+      OArchive oarchive(resultData);
+
+      oarchive << Detail::ResultTag::Exception << exceptionData;
+    }
+
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
     template <typename ArgumentTypes, typename Argument, typename... RemainingArguments>
-    void Marshaller<Dispatcher>::SerializeArguments(OArchive& archive, Argument&& argument, RemainingArguments&&... remainingArguments)
+    void Marshaller<Dispatcher, Serializer>::SerializeArguments(OArchive& archive, Argument&& argument, RemainingArguments&&... remainingArguments)
     {
-      using ArgumentType = std::remove_reference_t<boost::mpl::front<ArgumentTypes>::type>;
+      using ArgumentType = std::remove_reference_t<typename boost::mpl::front<ArgumentTypes>::type>;
 
       // check number of arguments (ArgumentTypes vs RemainingArguments)
       static_assert(boost::mpl::size<ArgumentTypes>::value == (sizeof...(remainingArguments)+1), "invalid numer of arguments supplied");
@@ -342,20 +706,20 @@ namespace CppRpc
       Serialize<ArgumentType>(archive, argument);
 
       // serialize remaining arguments using recursive call OR terminate recursion by calling sentinal overload
-      SerializeArguments<boost::mpl::pop_front<ArgumentTypes>::type>(archive, std::forward<RemainingArguments>(remainingArguments)...);
+      SerializeArguments<typename boost::mpl::pop_front<ArgumentTypes>::type>(archive, std::forward<RemainingArguments>(remainingArguments)...);
     }
 
 
     // sentinal overload to end recursion
-    template <template <InterfaceMode> class Dispatcher>
+    template <template <InterfaceMode> class Dispatcher, typename Serializer>
     template <typename ArgumentTypes>
-    void Marshaller<Dispatcher>::SerializeArguments(OArchive& /*archive*/)
+    void Marshaller<Dispatcher, Serializer>::SerializeArguments(OArchive& /*archive*/)
     {
       static_assert(boost::mpl::size<ArgumentTypes>::value == 0, "Not all arguments have been serialized, this overload must only be called as a recursion sentinal!");
     }
 
     template <template <InterfaceMode> class Dispatcher>
-    using DefaultMarshaller = Marshaller<Dispatcher>;
+    using DefaultMarshaller = Marshaller<Dispatcher, DefaultSerializer>;
 
   }  // namespace V1
 }  // namespace CppRpc
@@ -363,7 +727,7 @@ namespace CppRpc
 
 // macro BOOST_CLASS_VERSION is a bit quirky, does not work inside namespaces nor with forward declarations
 BOOST_CLASS_VERSION(CppRpc::V1::Version, CppRpc::V1::LibraryVersion)
-BOOST_CLASS_VERSION(CppRpc::V1::Detail::RemoteFunctionCall, CppRpc::V1::LibraryVersion)
+BOOST_CLASS_VERSION(CppRpc::V1::Detail::FunctionIdentity, CppRpc::V1::LibraryVersion)
 BOOST_CLASS_VERSION(CppRpc::V1::Detail::RemoteExceptionData, CppRpc::V1::LibraryVersion)
 
 #endif
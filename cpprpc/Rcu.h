@@ -0,0 +1,160 @@
+#ifndef CPPRPC_RCU_H
+#define CPPRPC_RCU_H
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstddef>
+#include <cassert>
+
+#include <boost/noncopyable.hpp>
+
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+    namespace Detail
+    {
+
+      // read-copy-update pointer to an immutable value
+      //
+      // readers never block, take no locks and copy nothing, they only increment a (per thread sharded) reader counter;
+      // writers publish a new value and wait until all readers of the old one are done before deleting it
+      //
+      // NOTE: writers need to be serialized by the caller and must not hold a ReadLock of the same RcuPointer (deadlock)
+      template <typename T>
+      class RcuPointer : boost::noncopyable
+      {
+        private:
+          static const std::size_t ShardCount = 32;
+          static const std::size_t CacheLineSize = 64;
+
+          // reader counter per epoch, sharded to avoid contention between reader threads
+          struct Shard
+          {
+            std::atomic<std::size_t> m_Readers[2];
+
+            char m_Padding[CacheLineSize - 2 * sizeof(std::atomic<std::size_t>)];
+          };
+
+        public:
+          // read-side critical section, value is guaranteed to stay alive until the ReadLock is destroyed
+          class ReadLock : boost::noncopyable
+          {
+            public:
+              explicit ReadLock(const RcuPointer& pointer)
+              : m_Shard(pointer.m_Shards[GetShardIndex()]), m_Epoch(pointer.m_Epoch.load()), m_Value(nullptr)
+              {
+                m_Shard.m_Readers[m_Epoch].fetch_add(1);
+
+                // load value after announcing the reader, see RcuPointer::Synchronize()
+                m_Value = pointer.m_Value.load();
+              }
+
+              ReadLock(ReadLock&& other)
+              : m_Shard(other.m_Shard), m_Epoch(other.m_Epoch), m_Value(other.m_Value)
+              {
+                other.m_Value = nullptr;
+              }
+
+              ~ReadLock()
+              {
+                if (m_Value != nullptr)
+                {
+                  m_Shard.m_Readers[m_Epoch].fetch_sub(1);
+                }
+              }
+
+              const T& operator*() const { return *m_Value; }
+              const T* operator->() const { return m_Value; }
+
+            private:
+              Shard&      m_Shard;
+              std::size_t m_Epoch;
+              const T*    m_Value;
+          };
+
+          explicit RcuPointer(std::unique_ptr<const T> value)
+          : m_Shards(), m_Epoch(0), m_Value(value.release())
+          {
+            assert(m_Value.load() != nullptr);
+
+            for (auto& shard : m_Shards)
+            {
+              shard.m_Readers[0] = 0;
+              shard.m_Readers[1] = 0;
+            }
+          }
+
+          ~RcuPointer()
+          {
+            delete m_Value.load();
+          }
+
+          ReadLock Read() const
+          {
+            return ReadLock(*this);
+          }
+
+          // publishes value, returns after all readers of the previous value are done
+          void Update(std::unique_ptr<const T> value)
+          {
+            assert(value);
+
+            std::unique_ptr<const T> oldValue(m_Value.exchange(value.release()));
+
+            Synchronize();
+          }
+
+        private:
+          mutable Shard            m_Shards[ShardCount];
+          std::atomic<std::size_t> m_Epoch;
+          std::atomic<const T*>    m_Value;
+
+          // waits for all readers that started before the call, new readers are counted in the other epoch meanwhile
+          // two epoch flips are needed as a reader may have loaded the epoch before but incremented its counter after the first flip
+          void Synchronize()
+          {
+            for (int i = 0; i < 2; ++i)
+            {
+              const std::size_t epoch = m_Epoch.load();
+
+              m_Epoch.store(epoch ^ 1);
+
+              while (GetReaderCount(epoch) != 0)
+              {
+                std::this_thread::yield();
+              }
+            }
+          }
+
+          std::size_t GetReaderCount(std::size_t epoch) const
+          {
+            std::size_t count = 0;
+
+            for (const auto& shard : m_Shards)
+            {
+              count += shard.m_Readers[epoch].load();
+            }
+
+            return count;
+          }
+
+          static std::size_t GetShardIndex()
+          {
+            static std::atomic<std::size_t> nextIndex(0);
+
+            thread_local const std::size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % ShardCount;
+
+            return index;
+          }
+      };
+
+    }  // namespace Detail
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif
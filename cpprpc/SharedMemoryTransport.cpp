@@ -0,0 +1,625 @@
+#include "cpprpc/SharedMemoryTransport.h"
+
+#if defined(__linux__)
+
+#include <thread>
+#include <algorithm>
+#include <new>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <cassert>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <boost/format.hpp>
+
+#include "cpprpc/Exception.h"
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    namespace
+    {
+
+      using namespace Detail;
+
+      using MessageSize = std::uint32_t;
+
+      // marks the rest of the ring as unused, the next message starts at the beginning of the ring
+      const MessageSize WrapMarker = ~MessageSize(0);
+
+      // messages are aligned to 8 bytes within the ring
+      const std::size_t MessageAlignment = 8;
+
+      // magic number, set last by the server after the segment was initialized
+      const std::uint32_t SegmentMagic = 0x43505252;  // "CPRR"
+
+      // changed with every change of the segment layout
+      const std::uint32_t SegmentLayout = 1;
+
+      const std::size_t MinSpinLimit = 16;
+      const std::size_t MaxSpinLimit = 4096;
+
+      struct SegmentHeader
+      {
+        std::atomic<std::uint32_t> m_Magic;
+        std::uint32_t              m_Layout;
+        std::uint64_t              m_RingCapacity;
+        SharedMemoryRingControl    m_Rings[2];  // client to server, server to client
+      };
+
+      std::size_t AlignMessage(std::size_t size)
+      {
+        return (size + MessageAlignment - 1) & ~(MessageAlignment - 1);
+      }
+
+      std::size_t GetSegmentSize(std::size_t ringCapacity)
+      {
+        return sizeof(SegmentHeader) + 2 * ringCapacity;
+      }
+
+      void CpuRelax()
+      {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+      }
+
+      // spins until condition is met, returns false if it was not met within limit iterations, adapts limit to how often spinning succeeded
+      template <typename Condition>
+      bool Spin(std::size_t& limit, Condition&& condition)
+      {
+        if (limit == 0)
+        {
+          return condition();
+        }
+
+        for (std::size_t i = 0; i < limit; ++i)
+        {
+          if (condition())
+          {
+            limit = std::min(limit * 2, MaxSpinLimit);
+
+            return true;
+          }
+
+          CpuRelax();
+        }
+
+        limit = std::max(limit / 2, MinSpinLimit);
+
+        return condition();
+      }
+
+      std::size_t GetInitialSpinLimit()
+      {
+        // the peer can not make progress while we spin on a single CPU
+        return (std::thread::hardware_concurrency() > 1) ? MinSpinLimit : 0;
+      }
+
+      // waits while futex has value, at most for timeout (if any), futex is shared between processes
+      void FutexWait(std::atomic<std::uint32_t>& futex, std::uint32_t value, const std::chrono::nanoseconds* timeout)
+      {
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex must be a plain 32 bit value");
+
+        timespec relativeTimeout = {};
+
+        if (timeout != nullptr)
+        {
+          relativeTimeout.tv_sec = static_cast<time_t>(timeout->count() / 1000000000);
+          relativeTimeout.tv_nsec = static_cast<long>(timeout->count() % 1000000000);
+        }
+
+        // spurious wake ups, timeouts and changed values are all handled by the caller
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&futex), FUTEX_WAIT, value, (timeout != nullptr) ? &relativeTimeout : nullptr, nullptr, 0);
+      }
+
+      void FutexWake(std::atomic<std::uint32_t>& futex)
+      {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&futex), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+      }
+
+      // wakes the other side if it is (about to go) sleeping on futex
+      void Notify(std::atomic<std::uint32_t>& futex, std::atomic<std::uint32_t>& waiting)
+      {
+        // pairs with the store to waiting and the following check in Sleep()
+        if (waiting.load(std::memory_order_seq_cst) != 0)
+        {
+          futex.fetch_add(1, std::memory_order_seq_cst);
+
+          FutexWake(futex);
+        }
+      }
+
+      // sleeps on futex unless condition is met meanwhile, returns false if the deadline expired
+      template <typename Condition>
+      bool Sleep(std::atomic<std::uint32_t>& futex, std::atomic<std::uint32_t>& waiting, const std::chrono::steady_clock::time_point* deadline, Condition&& condition)
+      {
+        const std::uint32_t value = futex.load(std::memory_order_seq_cst);
+
+        waiting.store(1, std::memory_order_seq_cst);
+
+        bool expired = false;
+
+        if (!condition())
+        {
+          if (deadline != nullptr)
+          {
+            const auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(*deadline - std::chrono::steady_clock::now());
+
+            if (timeout.count() > 0)
+            {
+              FutexWait(futex, value, &timeout);
+            }
+            else
+            {
+              expired = true;
+            }
+          }
+          else
+          {
+            FutexWait(futex, value, nullptr);
+          }
+        }
+
+        waiting.store(0, std::memory_order_relaxed);
+
+        return !expired;
+      }
+
+    }  // anonymous namespace
+
+
+    namespace Detail
+    {
+
+      SharedMemorySegment::SharedMemorySegment(const std::string& name, std::size_t size)
+      : m_Name(name), m_Owner(true), m_Data(nullptr), m_Size(size)
+      {
+        // replace stale segment left behind by a crashed server
+        shm_unlink(name.c_str());
+
+        const FileDescriptor segment(shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR));
+
+        if (segment.Get() < 0)
+        {
+          ThrowTransportError((boost::format("Unable to create shared memory segment \"%1%\"") % name).str());
+        }
+
+        if (ftruncate(segment.Get(), static_cast<off_t>(size)) != 0)
+        {
+          const int error = errno;
+
+          shm_unlink(name.c_str());
+
+          ThrowTransportError((boost::format("Unable to resize shared memory segment \"%1%\"") % name).str(), error);
+        }
+
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, segment.Get(), 0);
+
+        if (data == MAP_FAILED)
+        {
+          const int error = errno;
+
+          shm_unlink(name.c_str());
+
+          ThrowTransportError((boost::format("Unable to map shared memory segment \"%1%\"") % name).str(), error);
+        }
+
+        m_Data = static_cast<Byte*>(data);
+      }
+
+      SharedMemorySegment::SharedMemorySegment(const std::string& name)
+      : m_Name(name), m_Owner(false), m_Data(nullptr), m_Size(0)
+      {
+        const FileDescriptor segment(shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0));
+
+        if (segment.Get() < 0)
+        {
+          ThrowTransportError((boost::format("Unable to open shared memory segment \"%1%\"") % name).str());
+        }
+
+        struct stat status = {};
+
+        if (fstat(segment.Get(), &status) != 0)
+        {
+          ThrowTransportError((boost::format("Unable to get size of shared memory segment \"%1%\"") % name).str());
+        }
+
+        m_Size = static_cast<std::size_t>(status.st_size);
+
+        void* data = mmap(nullptr, m_Size, PROT_READ | PROT_WRITE, MAP_SHARED, segment.Get(), 0);
+
+        if (data == MAP_FAILED)
+        {
+          ThrowTransportError((boost::format("Unable to map shared memory segment \"%1%\"") % name).str());
+        }
+
+        m_Data = static_cast<Byte*>(data);
+      }
+
+      SharedMemorySegment::~SharedMemorySegment()
+      {
+        munmap(m_Data, m_Size);
+
+        if (m_Owner)
+        {
+          shm_unlink(m_Name.c_str());
+        }
+      }
+
+
+      SharedMemoryChannel::SharedMemoryChannel(const std::string& name, std::size_t ringCapacity, std::chrono::milliseconds receiveTimeout, std::chrono::milliseconds sendTimeout)
+      : m_Segment(name, GetSegmentSize(ringCapacity)), m_RingCapacity(ringCapacity), m_SendControl(nullptr), m_SendRing(nullptr), m_ReceiveControl(nullptr), m_ReceiveRing(nullptr),
+        m_ReceiveTimeout(receiveTimeout), m_SendTimeout(sendTimeout), m_SendMutex(), m_SendHead(0), m_ReceiveTail(0), m_LentTail(0), m_Interrupted(false), m_SendSpinLimit(GetInitialSpinLimit()), m_ReceiveSpinLimit(GetInitialSpinLimit())
+      {
+        assert((ringCapacity & (ringCapacity - 1)) == 0);
+
+        SegmentHeader* header = new (m_Segment.GetData()) SegmentHeader();
+
+        header->m_Layout = SegmentLayout;
+        header->m_RingCapacity = ringCapacity;
+
+        for (SharedMemoryRingControl& ring : header->m_Rings)
+        {
+          ring.m_Head = 0;
+          ring.m_Tail = 0;
+          ring.m_DataFutex = 0;
+          ring.m_ConsumerWaiting = 0;
+          ring.m_SpaceFutex = 0;
+          ring.m_ProducerWaiting = 0;
+        }
+
+        Attach(true);
+
+        // publish initialized segment
+        header->m_Magic.store(SegmentMagic, std::memory_order_release);
+      }
+
+      SharedMemoryChannel::SharedMemoryChannel(const std::string& name, std::chrono::milliseconds receiveTimeout, std::chrono::milliseconds sendTimeout)
+      : m_Segment(name), m_RingCapacity(0), m_SendControl(nullptr), m_SendRing(nullptr), m_ReceiveControl(nullptr), m_ReceiveRing(nullptr),
+        m_ReceiveTimeout(receiveTimeout), m_SendTimeout(sendTimeout), m_SendMutex(), m_SendHead(0), m_ReceiveTail(0), m_LentTail(0), m_Interrupted(false), m_SendSpinLimit(GetInitialSpinLimit()), m_ReceiveSpinLimit(GetInitialSpinLimit())
+      {
+        const SegmentHeader* header = reinterpret_cast<const SegmentHeader*>(m_Segment.GetData());
+
+        if ((m_Segment.GetSize() < sizeof(SegmentHeader)) || (header->m_Magic.load(std::memory_order_acquire) != SegmentMagic) || (header->m_Layout != SegmentLayout) ||
+            (m_Segment.GetSize() < GetSegmentSize(header->m_RingCapacity)))
+        {
+          throw ExceptionImpl<TransportError>((boost::format("Shared memory segment \"%1%\" is not initialized or incompatible") % name).str());
+        }
+
+        m_RingCapacity = header->m_RingCapacity;
+
+        Attach(false);
+
+        // continue where a previous client stopped
+        m_SendHead = m_SendControl->m_Head.load(std::memory_order_relaxed);
+        m_ReceiveTail = m_ReceiveControl->m_Tail.load(std::memory_order_relaxed);
+        m_LentTail = m_ReceiveTail;
+      }
+
+      void SharedMemoryChannel::Attach(bool server)
+      {
+        SegmentHeader* header = reinterpret_cast<SegmentHeader*>(m_Segment.GetData());
+        Byte* rings = m_Segment.GetData() + sizeof(SegmentHeader);
+
+        // client sends on ring 0, server on ring 1
+        const std::size_t sendRing = server ? 1 : 0;
+        const std::size_t receiveRing = 1 - sendRing;
+
+        m_SendControl = &header->m_Rings[sendRing];
+        m_SendRing = rings + sendRing * m_RingCapacity;
+        m_ReceiveControl = &header->m_Rings[receiveRing];
+        m_ReceiveRing = rings + receiveRing * m_RingCapacity;
+      }
+
+      void SharedMemoryChannel::Send(BufferView data)
+      {
+        SendSegments(&data, 1);
+      }
+
+      void SharedMemoryChannel::Send(const std::vector<BufferView>& segments)
+      {
+        SendSegments(segments.data(), segments.size());
+      }
+
+      void SharedMemoryChannel::SendSegments(const BufferView* segments, std::size_t segmentCount)
+      {
+        std::size_t size = 0;
+
+        for (std::size_t i = 0; i < segmentCount; ++i)
+        {
+          size += segments[i].size();
+        }
+
+        if (size > GetMaxMessageSize())
+        {
+          throw ExceptionImpl<TransportError>((boost::format("Message size %1% exceeds maximum message size %2%") % size % GetMaxMessageSize()).str());
+        }
+
+        const std::size_t messageSize = AlignMessage(sizeof(MessageSize) + size);
+
+        std::lock_guard<std::mutex> lock(m_SendMutex);
+
+        std::size_t offset = static_cast<std::size_t>(m_SendHead & (m_RingCapacity - 1));
+
+        // message is never split, skip rest of the ring if it does not fit
+        const std::size_t skip = ((m_RingCapacity - offset) < messageSize) ? (m_RingCapacity - offset) : 0;
+
+        const auto hasSpace = [this, messageSize, skip]
+          {
+            return (m_SendHead + skip + messageSize - m_SendControl->m_Tail.load(std::memory_order_acquire)) <= m_RingCapacity;
+          };
+
+        // started once the ring is found full, no clock read otherwise
+        auto deadline = std::chrono::steady_clock::time_point::min();
+
+        while (!Spin(m_SendSpinLimit, hasSpace))
+        {
+          if (deadline == std::chrono::steady_clock::time_point::min())
+          {
+            deadline = GetReceiveDeadline(m_SendTimeout);
+          }
+
+          if (!Sleep(m_SendControl->m_SpaceFutex, m_SendControl->m_ProducerWaiting, (deadline != std::chrono::steady_clock::time_point::max()) ? &deadline : nullptr, hasSpace))
+          {
+            // nothing written yet, the ring stays consistent
+            throw ExceptionImpl<TransportError>("Send timed out, peer does not receive");
+          }
+        }
+
+        if (skip > 0)
+        {
+          *reinterpret_cast<MessageSize*>(m_SendRing + offset) = WrapMarker;
+
+          m_SendHead += skip;
+          offset = 0;
+        }
+
+        *reinterpret_cast<MessageSize*>(m_SendRing + offset) = static_cast<MessageSize>(size);
+
+        Byte* position = m_SendRing + offset + sizeof(MessageSize);
+
+        for (std::size_t i = 0; i < segmentCount; ++i)
+        {
+          std::memcpy(position, segments[i].data(), segments[i].size());
+
+          position += segments[i].size();
+        }
+
+        m_SendHead += messageSize;
+
+        m_SendControl->m_Head.store(m_SendHead, std::memory_order_seq_cst);
+
+        Notify(m_SendControl->m_DataFutex, m_SendControl->m_ConsumerWaiting);
+      }
+
+      bool SharedMemoryChannel::Receive(Buffer& data)
+      {
+        BufferView message;
+
+        if (!ReceiveLent(message))
+        {
+          return false;
+        }
+
+        data.assign(message.begin(), message.end());
+
+        Return();
+
+        return true;
+      }
+
+      bool SharedMemoryChannel::ReceiveLent(BufferView& data)
+      {
+        assert(m_LentTail == m_ReceiveTail);
+
+        const auto deadline = GetReceiveDeadline(m_ReceiveTimeout);
+
+        const auto hasData = [this]
+          {
+            return m_ReceiveControl->m_Head.load(std::memory_order_acquire) != m_ReceiveTail;
+          };
+
+        const auto isReady = [this, &hasData]
+          {
+            return hasData() || m_Interrupted.load(std::memory_order_seq_cst);
+          };
+
+        for (;;)
+        {
+          while (!Spin(m_ReceiveSpinLimit, isReady))
+          {
+            if (!Sleep(m_ReceiveControl->m_DataFutex, m_ReceiveControl->m_ConsumerWaiting, (deadline != std::chrono::steady_clock::time_point::max()) ? &deadline : nullptr, isReady))
+            {
+              return false;
+            }
+          }
+
+          if (!hasData())
+          {
+            // interrupted
+            m_Interrupted.store(false, std::memory_order_relaxed);
+
+            return false;
+          }
+
+          const std::size_t offset = static_cast<std::size_t>(m_ReceiveTail & (m_RingCapacity - 1));
+
+          const MessageSize size = *reinterpret_cast<const MessageSize*>(m_ReceiveRing + offset);
+
+          if (size == WrapMarker)
+          {
+            m_ReceiveTail += m_RingCapacity - offset;
+            m_LentTail = m_ReceiveTail;
+
+            continue;
+          }
+
+          // the producer does not overwrite the message before the tail is moved past it, see Return()
+          data = BufferView(m_ReceiveRing + offset + sizeof(MessageSize), size);
+
+          m_LentTail = m_ReceiveTail + AlignMessage(sizeof(MessageSize) + size);
+
+          return true;
+        }
+      }
+
+      void SharedMemoryChannel::Return()
+      {
+        if (m_LentTail == m_ReceiveTail)
+        {
+          return;
+        }
+
+        m_ReceiveTail = m_LentTail;
+
+        m_ReceiveControl->m_Tail.store(m_ReceiveTail, std::memory_order_seq_cst);
+
+        Notify(m_ReceiveControl->m_SpaceFutex, m_ReceiveControl->m_ProducerWaiting);
+      }
+
+      void SharedMemoryChannel::Interrupt()
+      {
+        m_Interrupted.store(true, std::memory_order_seq_cst);
+
+        // the receiving thread of this process is the only one sleeping on the data futex of the receive ring
+        m_ReceiveControl->m_DataFutex.fetch_add(1, std::memory_order_seq_cst);
+
+        FutexWake(m_ReceiveControl->m_DataFutex);
+      }
+
+    }  // namespace Detail
+
+
+    namespace
+    {
+
+      std::size_t RoundUpToPowerOfTwo(std::size_t value)
+      {
+        std::size_t result = 1024;
+
+        while (result < value)
+        {
+          result *= 2;
+        }
+
+        return result;
+      }
+
+    }  // anonymous namespace
+
+
+    SharedMemoryServerTransport::SharedMemoryServerTransport(const std::string& name, std::size_t ringCapacity, std::chrono::milliseconds receiveTimeout,
+                                                             std::chrono::milliseconds sendTimeout)
+    : Transport<InterfaceMode::Server>(), m_Channel(name, RoundUpToPowerOfTwo(ringCapacity), receiveTimeout, sendTimeout), m_BufferPool()
+    {}
+
+    void SharedMemoryServerTransport::Send(const Buffer& data)
+    {
+      m_Channel.Send(data);
+    }
+
+    void SharedMemoryServerTransport::Send(const Segments& segments)
+    {
+      m_Channel.Send(segments);
+    }
+
+    Buffer SharedMemoryServerTransport::Acquire()
+    {
+      return m_BufferPool.Acquire();
+    }
+
+    void SharedMemoryServerTransport::Commit(Buffer&& data)
+    {
+      // one copy into the ring, the buffer was serialized into outside of shared memory
+      m_Channel.Send(data);
+
+      // reuse the buffer
+      m_BufferPool.Recycle(std::move(data));
+    }
+
+    bool SharedMemoryServerTransport::Receive(Buffer& data)
+    {
+      return m_Channel.Receive(data);
+    }
+
+    bool SharedMemoryServerTransport::ReceiveLent(BufferView& data)
+    {
+      return m_Channel.ReceiveLent(data);
+    }
+
+    void SharedMemoryServerTransport::Return()
+    {
+      m_Channel.Return();
+    }
+
+    void SharedMemoryServerTransport::Interrupt()
+    {
+      m_Channel.Interrupt();
+    }
+
+
+    SharedMemoryClientTransport::SharedMemoryClientTransport(const std::string& name, std::chrono::milliseconds receiveTimeout, std::chrono::milliseconds sendTimeout)
+    : Transport<InterfaceMode::Client>(), m_Channel(name, receiveTimeout, sendTimeout), m_BufferPool()
+    {}
+
+    void SharedMemoryClientTransport::Send(const Buffer& data)
+    {
+      m_Channel.Send(data);
+    }
+
+    void SharedMemoryClientTransport::Send(const Segments& segments)
+    {
+      m_Channel.Send(segments);
+    }
+
+    Buffer SharedMemoryClientTransport::Acquire()
+    {
+      return m_BufferPool.Acquire();
+    }
+
+    void SharedMemoryClientTransport::Commit(Buffer&& data)
+    {
+      // one copy into the ring, the buffer was serialized into outside of shared memory
+      m_Channel.Send(data);
+
+      // reuse the buffer
+      m_BufferPool.Recycle(std::move(data));
+    }
+
+    bool SharedMemoryClientTransport::Receive(Buffer& data)
+    {
+      return m_Channel.Receive(data);
+    }
+
+    bool SharedMemoryClientTransport::ReceiveLent(BufferView& data)
+    {
+      return m_Channel.ReceiveLent(data);
+    }
+
+    void SharedMemoryClientTransport::Return()
+    {
+      m_Channel.Return();
+    }
+
+    void SharedMemoryClientTransport::Interrupt()
+    {
+      m_Channel.Interrupt();
+    }
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
@@ -0,0 +1,202 @@
+#ifndef CPPRPC_SHAREDMEMORYTRANSPORT_H
+#define CPPRPC_SHAREDMEMORYTRANSPORT_H
+
+#pragma once
+
+// shared memory transport is built on POSIX shared memory and futexes, Linux only for now
+#if defined(__linux__)
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#include <boost/noncopyable.hpp>
+
+#include "cpprpc/Types.h"
+#include "cpprpc/Transport.h"
+#include "cpprpc/IoEngine.h"
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+    namespace Detail
+    {
+
+      // control block of a single producer / single consumer ring, placed in shared memory
+      struct SharedMemoryRingControl
+      {
+        alignas(64) std::atomic<std::uint64_t> m_Head;             // written by the producer
+        alignas(64) std::atomic<std::uint64_t> m_Tail;             // written by the consumer
+        alignas(64) std::atomic<std::uint32_t> m_DataFutex;        // changed by the producer if the consumer sleeps
+                    std::atomic<std::uint32_t> m_ConsumerWaiting;
+        alignas(64) std::atomic<std::uint32_t> m_SpaceFutex;       // changed by the consumer if the producer sleeps
+                    std::atomic<std::uint32_t> m_ProducerWaiting;
+      };
+
+      // owns the mapping of a shared memory segment
+      class SharedMemorySegment : boost::noncopyable
+      {
+        public:
+          // creates a new segment (replacing a stale one with the same name), unlinked on destruction
+          SharedMemorySegment(const std::string& name, std::size_t size);
+
+          // opens an existing segment
+          explicit SharedMemorySegment(const std::string& name);
+
+          ~SharedMemorySegment();
+
+          Byte* GetData() const { return m_Data; }
+
+          std::size_t GetSize() const { return m_Size; }
+
+        private:
+          std::string m_Name;
+          bool        m_Owner;
+          Byte*       m_Data;
+          std::size_t m_Size;
+      };
+
+      // one end of a pair of rings, messages are copied straight into / out of shared memory
+      class SharedMemoryChannel : boost::noncopyable
+      {
+        public:
+          // server creates and initializes the segment, the client opens it
+          SharedMemoryChannel(const std::string& name, std::size_t ringCapacity, std::chrono::milliseconds receiveTimeout, std::chrono::milliseconds sendTimeout);
+          SharedMemoryChannel(const std::string& name, std::chrono::milliseconds receiveTimeout, std::chrono::milliseconds sendTimeout);
+
+          std::size_t GetMaxMessageSize() const { return m_RingCapacity / 2 - sizeof(std::uint32_t); }
+
+          // thread safe, blocks while the ring is full, throws TransportError if data exceeds GetMaxMessageSize() or if the ring stays full
+          // for longer than the send timeout (the peer does not receive)
+          void Send(BufferView data);
+
+          // thread safe, segments are copied into the ring one after the other
+          void Send(const std::vector<BufferView>& segments);
+
+          // returns false after the timeout expired or if interrupted
+          bool Receive(Buffer& data);
+
+          // the message is lent in place in the ring, its space is only released by Return()
+          bool ReceiveLent(BufferView& data);
+          void Return();
+
+          // thread safe, see Transport::Interrupt()
+          void Interrupt();
+
+        private:
+          SharedMemorySegment m_Segment;
+          std::size_t         m_RingCapacity;  // power of two
+
+          SharedMemoryRingControl* m_SendControl;
+          Byte*                    m_SendRing;
+          SharedMemoryRingControl* m_ReceiveControl;
+          Byte*                    m_ReceiveRing;
+
+          std::chrono::milliseconds m_ReceiveTimeout;
+          std::chrono::milliseconds m_SendTimeout;
+
+          std::mutex    m_SendMutex;
+          std::uint64_t m_SendHead;     // guarded by m_SendMutex
+          std::uint64_t m_ReceiveTail;  // receiving thread only
+          std::uint64_t m_LentTail;     // tail after the lent message, m_ReceiveTail while none is lent
+
+          std::atomic<bool> m_Interrupted;  // local to this process, the data futex is only shared to wake up the receiving thread
+
+          // adaptive spinning before sleeping, no spinning on a single CPU
+          std::size_t m_SendSpinLimit;
+          std::size_t m_ReceiveSpinLimit;
+
+          void Attach(bool server);
+
+          void SendSegments(const BufferView* segments, std::size_t segmentCount);
+      };
+
+    }  // namespace Detail
+
+
+    const std::size_t SharedMemoryDefaultRingCapacity = 4 * 1024 * 1024;
+
+    const std::chrono::milliseconds SharedMemoryDefaultReceiveTimeout = InfiniteReceiveTimeout;
+
+    // longest wait for space in a full ring, InfiniteReceiveTimeout waits forever
+    const std::chrono::milliseconds SharedMemoryDefaultSendTimeout = std::chrono::seconds(10);
+
+
+    // creates the shared memory segment name (see shm_open()), serves a single client process
+    class SharedMemoryServerTransport : public Transport<InterfaceMode::Server>
+    {
+      public:
+        // ring capacity (per direction) is rounded up to a power of two, half of it is the maximum message size
+        explicit SharedMemoryServerTransport(const std::string& name, std::size_t ringCapacity = SharedMemoryDefaultRingCapacity,
+                                             std::chrono::milliseconds receiveTimeout = SharedMemoryDefaultReceiveTimeout,
+                                             std::chrono::milliseconds sendTimeout = SharedMemoryDefaultSendTimeout);
+
+        virtual ~SharedMemoryServerTransport() noexcept override = default;
+
+        std::size_t GetMaxMessageSize() const { return m_Channel.GetMaxMessageSize(); }
+
+        using Transport<InterfaceMode::Server>::Send;
+
+        virtual void Send(const Buffer& data) override;
+        virtual void Send(const Segments& segments) override;
+
+        // pooled heap buffers, Commit() copies the message into the ring (no ring space is lent out while a message is serialized)
+        virtual Buffer Acquire() override;
+        virtual void Commit(Buffer&& data) override;
+
+        virtual bool Receive(Buffer& data) override;
+
+        virtual bool ReceiveLent(BufferView& data) override;
+        virtual void Return() override;
+
+        virtual void Interrupt() override;
+
+      private:
+        Detail::SharedMemoryChannel m_Channel;
+        Detail::BufferPool          m_BufferPool;
+    };
+
+
+    // opens the shared memory segment created by a SharedMemoryServerTransport
+    class SharedMemoryClientTransport : public Transport<InterfaceMode::Client>
+    {
+      public:
+        explicit SharedMemoryClientTransport(const std::string& name, std::chrono::milliseconds receiveTimeout = SharedMemoryDefaultReceiveTimeout,
+                                             std::chrono::milliseconds sendTimeout = SharedMemoryDefaultSendTimeout);
+
+        virtual ~SharedMemoryClientTransport() noexcept override = default;
+
+        std::size_t GetMaxMessageSize() const { return m_Channel.GetMaxMessageSize(); }
+
+        using Transport<InterfaceMode::Client>::Send;
+
+        virtual void Send(const Buffer& data) override;
+        virtual void Send(const Segments& segments) override;
+
+        // pooled heap buffers, Commit() copies the message into the ring (no ring space is lent out while a message is serialized)
+        virtual Buffer Acquire() override;
+        virtual void Commit(Buffer&& data) override;
+
+        virtual bool Receive(Buffer& data) override;
+
+        virtual bool ReceiveLent(BufferView& data) override;
+        virtual void Return() override;
+
+        virtual void Interrupt() override;
+
+      private:
+        Detail::SharedMemoryChannel m_Channel;
+        Detail::BufferPool          m_BufferPool;
+    };
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
+
+#endif
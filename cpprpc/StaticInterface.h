@@ -0,0 +1,187 @@
+#ifndef CPPRPC_STATICINTERFACE_H
+#define CPPRPC_STATICINTERFACE_H
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+#include <boost/function_types/result_type.hpp>
+#include <boost/function_types/parameter_types.hpp>
+
+#include "cpprpc/Types.h"
+#include "cpprpc/Interface.h"
+#include "cpprpc/Marshaller.h"
+#include "cpprpc/Dispatcher.h"
+
+namespace CppRpc
+{
+
+  inline namespace V1
+  {
+
+    // function of a StaticInterface, everything known at compile time: signature T, implementation (a plain function, called directly)
+    // and name (a null terminated character array with linkage, e.g. "constexpr char EchoName[] = "Echo";" at namespace scope)
+    template <typename T, T* Implementation, const char* Name, ExecutionPolicy Policy = ExecutionPolicy::Offload>
+    struct StaticFunction
+    {};
+
+    // same for one-way functions, see OneWayFunctionTag
+    template <typename T, T* Implementation, const char* Name, ExecutionPolicy Policy = ExecutionPolicy::Offload>
+    struct StaticOneWayFunction
+    {};
+
+    namespace Detail
+    {
+
+      // entry of the dispatch table of a StaticInterface
+      struct StaticFunctionEntry
+      {
+        const char*                                                     m_Name;
+        Dispatcher<InterfaceMode::Server>::StaticFunctionImplementation m_Implementation;
+        ExecutionPolicy                                                 m_ExecutionPolicy;
+      };
+
+      // calls Implementation directly, i.e. the call can be inlined into the de-serialization of its parameters
+      template <typename T, T* Implementation>
+      struct StaticCall
+      {
+        template <typename... Arguments>
+        auto operator()(Arguments&&... arguments) const -> decltype(Implementation(std::forward<Arguments>(arguments)...))
+        {
+          return Implementation(std::forward<Arguments>(arguments)...);
+        }
+      };
+
+      template <typename T>
+      struct StaticFunctionTypes
+      {
+        static_assert(std::is_function<T>::value, "T must be a function type (like \"void(int)\")");
+
+        using ReturnType = typename boost::function_types::result_type<T>::type;
+        using ParamTypes = typename boost::function_types::parameter_types<T>::type;
+      };
+
+      template <typename Function>
+      struct StaticFunctionTraits;
+
+      template <typename T, T* Implementation, const char* Name, ExecutionPolicy Policy>
+      struct StaticFunctionTraits<StaticFunction<T, Implementation, Name, Policy>> : StaticFunctionTypes<T>
+      {
+        static void Execute(BufferView paramData, Buffer& resultData)
+        {
+          StaticCall<T, Implementation> implementation;
+
+          DefaultMarshaller<Dispatcher>::template DeserializeAndExecuteFunctionCall<typename StaticFunctionTypes<T>::ReturnType,
+                                                                                   typename StaticFunctionTypes<T>::ParamTypes>(paramData, resultData, implementation);
+        }
+
+        static constexpr StaticFunctionEntry GetEntry()
+        {
+          return {Name, &Execute, Policy};
+        }
+      };
+
+      template <typename T, T* Implementation, const char* Name, ExecutionPolicy Policy>
+      struct StaticFunctionTraits<StaticOneWayFunction<T, Implementation, Name, Policy>> : StaticFunctionTypes<T>
+      {
+        static_assert(std::is_void<typename StaticFunctionTypes<T>::ReturnType>::value, "one-way functions must not return a value");
+
+        // exceptions thrown by one-way functions are counted and logged by the dispatcher
+        static void Execute(BufferView paramData, Buffer& /*resultData*/)
+        {
+          StaticCall<T, Implementation> implementation;
+
+          DefaultMarshaller<Dispatcher>::template DeserializeAndExecuteOneWayFunctionCall<typename StaticFunctionTypes<T>::ParamTypes>(paramData, implementation);
+        }
+
+        static constexpr StaticFunctionEntry GetEntry()
+        {
+          return {Name, &Execute, Policy};
+        }
+      };
+
+    }  // namespace Detail
+
+
+    // server side interface with a function list fixed at compile time, e.g.
+    //   StaticInterface<StaticFunction<int(int), &Echo, EchoName>, StaticOneWayFunction<void(int), &Log, LogName>>
+    //
+    // calls go through a constexpr table of plain function pointers (indexed by the position in Functions) to code calling the implementation
+    // directly, no type erasure and no heap allocation per function; clients use ordinary Interface::Function instances,
+    // runtime registered functions (of other interfaces) are served by the same dispatcher next to it
+    template <typename... Functions>
+    class StaticInterface : public Interface<InterfaceMode::Server>
+    {
+        static_assert(sizeof...(Functions) > 0, "a StaticInterface needs at least one function");
+
+      public:
+        static constexpr std::size_t FunctionCount = sizeof...(Functions);
+
+        StaticInterface(Transport<InterfaceMode::Server>& transport, const Name& name, Version version = {1, 0})
+        : StaticInterface(MakeDispatcherHandle(transport), name, version)
+        {}
+
+        // registers all functions, none if one of them fails
+        StaticInterface(const DispatcherHandle& dispatcher, const Name& name, Version version = {1, 0})
+        : Interface<InterfaceMode::Server>(dispatcher, name, version)
+        {
+          std::size_t registered = 0;
+
+          try
+          {
+            for (; registered < FunctionCount; ++registered)
+            {
+              const Detail::StaticFunctionEntry& function = s_Functions[registered];
+
+              GetDispatcher()->RegisterStaticFunctionImplementation(*this, function.m_Name, function.m_Implementation, function.m_ExecutionPolicy);
+            }
+          }
+
+          catch (...)
+          {
+            Deregister(registered);
+
+            throw;
+          }
+        }
+
+        virtual ~StaticInterface() noexcept override
+        {
+          Deregister(FunctionCount);
+        }
+
+      private:
+        static constexpr Detail::StaticFunctionEntry s_Functions[sizeof...(Functions)] = {Detail::StaticFunctionTraits<Functions>::GetEntry()...};
+
+        // deregisters the first count functions
+        void Deregister(std::size_t count) noexcept
+        {
+          while (count > 0)
+          {
+            --count;
+
+            try
+            {
+              GetDispatcher()->DeregisterFunctionImplementation(*this, s_Functions[count].m_Name);
+            }
+
+            catch (...)
+            {
+              // TODO: add trace / logging
+            }
+          }
+        }
+    };
+
+    template <typename... Functions>
+    constexpr std::size_t StaticInterface<Functions...>::FunctionCount;
+
+    template <typename... Functions>
+    constexpr Detail::StaticFunctionEntry StaticInterface<Functions...>::s_Functions[sizeof...(Functions)];
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif
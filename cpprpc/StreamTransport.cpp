@@ -0,0 +1,958 @@
+#include "cpprpc/StreamTransport.h"
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <climits>
+#include <limits>
+#include <algorithm>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+
+#include <boost/format.hpp>
+
+#include "cpprpc/Exception.h"
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    namespace
+    {
+
+      using FrameSize = std::uint32_t;
+
+      // set in the size prefix of frames handed over as file, no data follows the size prefix
+      const FrameSize FileFrameFlag = FrameSize(1) << 31;
+
+      static_assert(StreamMaxFrameSize < FileFrameFlag, "frame size must not overlap with the file frame flag");
+
+      // accepting is paused this long if a pending connection can neither be accepted nor rejected, see StreamServerTransport::PauseAccept()
+      const long AcceptRetryDelayMs = 100;
+
+      // seals a receiver relies on, the sender can neither change nor shrink the file while it is mapped
+      const int RequiredSeals = F_SEAL_SHRINK | F_SEAL_WRITE;
+
+      // owns a writable memory mapping, populated up front as the whole frame is copied into it
+      class Mapping : boost::noncopyable
+      {
+        public:
+          Mapping(std::size_t size, int protection, int file)
+          : m_Address(mmap(nullptr, size, protection, MAP_SHARED | MAP_POPULATE, file, 0)), m_Size(size)
+          {}
+
+          ~Mapping()
+          {
+            if (IsValid())
+            {
+              munmap(m_Address, m_Size);
+            }
+          }
+
+          bool IsValid() const { return m_Address != MAP_FAILED; }
+
+          Byte* Get() const { return static_cast<Byte*>(m_Address); }
+
+        private:
+          void*       m_Address;
+          std::size_t m_Size;
+      };
+
+    }  // anonymous namespace
+
+
+    namespace Detail
+    {
+
+      StreamConnection::StreamConnection(int socket, std::size_t fileThreshold, std::chrono::milliseconds sendTimeout)
+      : m_Socket(socket), m_FileThreshold(fileThreshold), m_SendTimeout(sendTimeout), m_Connected(true), m_SendMutex(), m_ReceiveBuffer(), m_ReceivePosition(0), m_ReceivedFiles(),
+        m_LentMapping(nullptr), m_LentMappingSize(0)
+      {
+        assert(socket >= 0);
+      }
+
+      StreamConnection::~StreamConnection()
+      {
+        ReturnFrame();
+
+        for (int file : m_ReceivedFiles)
+        {
+          close(file);
+        }
+      }
+
+      void StreamConnection::Send(BufferView data)
+      {
+        SendFrame(&data, 1);
+      }
+
+      void StreamConnection::Send(const std::vector<BufferView>& segments)
+      {
+        SendFrame(segments.data(), segments.size());
+      }
+
+      void StreamConnection::SendFrame(const BufferView* segments, std::size_t segmentCount)
+      {
+        std::size_t size = 0;
+
+        for (std::size_t i = 0; i < segmentCount; ++i)
+        {
+          size += segments[i].size();
+        }
+
+        if (size > StreamMaxFrameSize)
+        {
+          throw ExceptionImpl<TransportError>((boost::format("Frame size %1% exceeds maximum frame size %2%") % size % StreamMaxFrameSize).str());
+        }
+
+        if ((m_FileThreshold > 0) && (size >= m_FileThreshold))
+        {
+          SendFile(segments, segmentCount, size);
+
+          return;
+        }
+
+        // more segments than sendmsg() takes at once, concatenate them
+        if (segmentCount >= IOV_MAX)
+        {
+          Buffer data;
+
+          data.reserve(size);
+
+          for (std::size_t i = 0; i < segmentCount; ++i)
+          {
+            data.insert(data.end(), segments[i].begin(), segments[i].end());
+          }
+
+          const BufferView frame(data);
+
+          SendFrame(&frame, 1);
+
+          return;
+        }
+
+        // frame size (little endian) and data are written with a single system call
+        Byte header[sizeof(FrameSize)];
+
+        for (std::size_t i = 0; i < sizeof(FrameSize); ++i)
+        {
+          header[i] = static_cast<Byte>(static_cast<FrameSize>(size) >> (8 * i));
+        }
+
+        // header and common (small) segment counts on the stack
+        iovec fixedParts[8];
+        std::vector<iovec> moreParts;
+
+        iovec* parts = fixedParts;
+
+        if (segmentCount + 1 > (sizeof(fixedParts) / sizeof(fixedParts[0])))
+        {
+          moreParts.resize(segmentCount + 1);
+          parts = moreParts.data();
+        }
+
+        parts[0] = {header, sizeof(header)};
+
+        for (std::size_t i = 0; i < segmentCount; ++i)
+        {
+          parts[i + 1] = {const_cast<Byte*>(segments[i].data()), segments[i].size()};
+        }
+
+        msghdr message = {};
+
+        message.msg_iov = parts;
+        message.msg_iovlen = segmentCount + 1;
+
+        std::lock_guard<std::mutex> lock(m_SendMutex);
+
+        SendMessage(message);
+      }
+
+      void StreamConnection::SendFile(const BufferView* segments, std::size_t segmentCount, std::size_t size)
+      {
+        // data is copied into a new file once, the receiver maps the very same pages
+        const FileDescriptor file(memfd_create("cpprpc-frame", MFD_CLOEXEC | MFD_ALLOW_SEALING));
+
+        if (file.Get() < 0)
+        {
+          ThrowTransportError("Unable to create memfd");
+        }
+
+        if (ftruncate(file.Get(), static_cast<off_t>(size)) != 0)
+        {
+          ThrowTransportError("Unable to resize memfd");
+        }
+
+        {
+          const Mapping mapping(size, PROT_READ | PROT_WRITE, file.Get());
+
+          if (!mapping.IsValid())
+          {
+            ThrowTransportError("Unable to map memfd");
+          }
+
+          Byte* position = mapping.Get();
+
+          for (std::size_t i = 0; i < segmentCount; ++i)
+          {
+            std::memcpy(position, segments[i].data(), segments[i].size());
+
+            position += segments[i].size();
+          }
+        }
+
+        // writable mappings must be gone before sealing
+        if (fcntl(file.Get(), F_ADD_SEALS, RequiredSeals | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+        {
+          ThrowTransportError("Unable to seal memfd");
+        }
+
+        Byte header[sizeof(FrameSize)];
+
+        for (std::size_t i = 0; i < sizeof(FrameSize); ++i)
+        {
+          header[i] = static_cast<Byte>((static_cast<FrameSize>(size) | FileFrameFlag) >> (8 * i));
+        }
+        iovec part = {header, sizeof(header)};
+
+        union
+        {
+          cmsghdr m_Header;  // alignment
+          char    m_Data[CMSG_SPACE(sizeof(int))];
+        } control;
+
+        std::memset(&control, 0, sizeof(control));
+
+        msghdr message = {};
+
+        message.msg_iov = &part;
+        message.msg_iovlen = 1;
+        message.msg_control = control.m_Data;
+        message.msg_controllen = sizeof(control.m_Data);
+
+        cmsghdr* fileHeader = CMSG_FIRSTHDR(&message);
+
+        fileHeader->cmsg_level = SOL_SOCKET;
+        fileHeader->cmsg_type = SCM_RIGHTS;
+        fileHeader->cmsg_len = CMSG_LEN(sizeof(int));
+
+        const int fd = file.Get();
+
+        std::memcpy(CMSG_DATA(fileHeader), &fd, sizeof(fd));
+
+        std::lock_guard<std::mutex> lock(m_SendMutex);
+
+        SendMessage(message);
+      }
+
+      void StreamConnection::SendMessage(msghdr& message)
+      {
+        if (!m_Connected)
+        {
+          throw ExceptionImpl<TransportError>("Connection closed");
+        }
+
+        // started once the socket buffer is full, restarted whenever the peer took some data
+        auto deadline = std::chrono::steady_clock::time_point::min();
+
+        while (message.msg_iovlen > 0)
+        {
+          const ssize_t result = sendmsg(m_Socket.Get(), &message, MSG_NOSIGNAL);
+
+          if (result < 0)
+          {
+            if (errno == EINTR)
+            {
+              continue;
+            }
+
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+              // socket buffer full, wait until the peer caught up, but not forever while holding the send mutex
+              if (deadline == std::chrono::steady_clock::time_point::min())
+              {
+                deadline = GetReceiveDeadline(m_SendTimeout);
+              }
+
+              const auto now = std::chrono::steady_clock::now();
+
+              if (now >= deadline)
+              {
+                // part of the frame may be sent already, there is no way to continue the stream
+                Shutdown();
+
+                throw ExceptionImpl<TransportError>("Send timed out, peer does not receive");
+              }
+
+              // round up, avoids busy waiting for the last fraction of a millisecond
+              const auto timeout = std::min(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now + std::chrono::microseconds(999)),
+                                            std::chrono::milliseconds(std::numeric_limits<int>::max()));
+
+              pollfd writable = {m_Socket.Get(), POLLOUT, 0};
+
+              poll(&writable, 1, static_cast<int>(timeout.count()));
+
+              continue;
+            }
+
+            m_Connected = false;
+
+            ThrowTransportError("Unable to send frame");
+          }
+
+          deadline = std::chrono::steady_clock::time_point::min();
+
+          // files are sent with the first part only
+          message.msg_control = nullptr;
+          message.msg_controllen = 0;
+
+          // skip parts already sent, adjust partially sent part
+          std::size_t sent = static_cast<std::size_t>(result);
+
+          while ((message.msg_iovlen > 0) && (sent >= message.msg_iov->iov_len))
+          {
+            sent -= message.msg_iov->iov_len;
+
+            ++message.msg_iov;
+            --message.msg_iovlen;
+          }
+
+          if (sent > 0)
+          {
+            message.msg_iov->iov_base = static_cast<Byte*>(message.msg_iov->iov_base) + sent;
+            message.msg_iov->iov_len -= sent;
+          }
+        }
+      }
+
+      void StreamConnection::Append(BufferView data)
+      {
+        if (data.empty())
+        {
+          m_Connected = false;
+
+          return;
+        }
+
+        // drop frames already returned by ReadFrame(), a lent frame was returned before the I/O engine is waited for again
+        if (m_ReceivePosition > 0)
+        {
+          m_ReceiveBuffer.erase(m_ReceiveBuffer.begin(), m_ReceiveBuffer.begin() + m_ReceivePosition);
+          m_ReceivePosition = 0;
+        }
+
+        m_ReceiveBuffer.insert(m_ReceiveBuffer.end(), data.begin(), data.end());
+      }
+
+      void StreamConnection::AppendFile(int file)
+      {
+        // every file belongs to a file frame, its size prefix follows with the data received next; more files pending than file frames
+        // received (plus that one) are never sent by a well-behaved peer, they would only pile up
+        if (!m_Connected || (m_ReceivedFiles.size() > CountFileFrames()))
+        {
+          close(file);
+
+          // TODO: add trace / logging
+          Shutdown();
+
+          return;
+        }
+
+        m_ReceivedFiles.push_back(file);
+      }
+
+      std::size_t StreamConnection::CountFileFrames() const
+      {
+        std::size_t count = 0;
+        std::size_t position = m_ReceivePosition;
+
+        while (m_ReceiveBuffer.size() - position >= sizeof(FrameSize))
+        {
+          FrameSize size = 0;
+
+          for (std::size_t i = 0; i < sizeof(FrameSize); ++i)
+          {
+            size |= static_cast<FrameSize>(m_ReceiveBuffer[position + i]) << (8 * i);
+          }
+
+          position += sizeof(FrameSize);
+
+          if ((size & FileFrameFlag) != 0)
+          {
+            ++count;
+          }
+          else if (m_ReceiveBuffer.size() - position >= size)
+          {
+            position += size;
+          }
+          else
+          {
+            // incomplete frame
+            break;
+          }
+        }
+
+        return count;
+      }
+
+      bool StreamConnection::ReadFrame(Buffer& data)
+      {
+        BufferView frame;
+
+        if (!ReadFrame(frame))
+        {
+          return false;
+        }
+
+        data.assign(frame.begin(), frame.end());
+
+        ReturnFrame();
+
+        return true;
+      }
+
+      bool StreamConnection::ReadFrame(BufferView& data)
+      {
+        assert(m_LentMapping == nullptr);
+
+        const std::size_t available = m_ReceiveBuffer.size() - m_ReceivePosition;
+
+        if (available < sizeof(FrameSize))
+        {
+          return false;
+        }
+
+        FrameSize size = 0;
+
+        for (std::size_t i = 0; i < sizeof(FrameSize); ++i)
+        {
+          size |= static_cast<FrameSize>(m_ReceiveBuffer[m_ReceivePosition + i]) << (8 * i);
+        }
+
+        const bool isFile = (size & FileFrameFlag) != 0;
+
+        size &= ~FileFrameFlag;
+
+        if (size > StreamMaxFrameSize)
+        {
+          // protocol error, there is no way to find the start of the next frame
+          // TODO: add trace / logging
+          Shutdown();
+
+          return false;
+        }
+
+        if (isFile)
+        {
+          // file was received before (or together with) the size prefix
+          if (!MapFile(size, data))
+          {
+            // TODO: add trace / logging
+            Shutdown();
+
+            return false;
+          }
+
+          m_ReceivePosition += sizeof(FrameSize);
+        }
+        else
+        {
+          if (available < sizeof(FrameSize) + size)
+          {
+            return false;
+          }
+
+          // stays in place until the next Append()
+          data = BufferView(m_ReceiveBuffer.data() + m_ReceivePosition + sizeof(FrameSize), size);
+
+          m_ReceivePosition += sizeof(FrameSize) + size;
+        }
+
+        return true;
+      }
+
+      void StreamConnection::ReturnFrame()
+      {
+        if (m_LentMapping != nullptr)
+        {
+          munmap(m_LentMapping, m_LentMappingSize);
+
+          m_LentMapping = nullptr;
+          m_LentMappingSize = 0;
+        }
+      }
+
+      bool StreamConnection::MapFile(std::size_t size, BufferView& data)
+      {
+        if (m_ReceivedFiles.empty())
+        {
+          return false;
+        }
+
+        const FileDescriptor file(m_ReceivedFiles.front());
+
+        m_ReceivedFiles.erase(m_ReceivedFiles.begin());
+
+        // an unsealed file could be truncated while mapped (SIGBUS)
+        struct stat status = {};
+
+        if (((fcntl(file.Get(), F_GET_SEALS) & RequiredSeals) != RequiredSeals) || (fstat(file.Get(), &status) != 0) || (static_cast<std::size_t>(status.st_size) < size))
+        {
+          return false;
+        }
+
+        if (size == 0)
+        {
+          data = BufferView();
+
+          return true;
+        }
+
+        // mapping stays valid after closing the file, it is removed by ReturnFrame()
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED | MAP_POPULATE, file.Get(), 0);
+
+        if (mapping == MAP_FAILED)
+        {
+          return false;
+        }
+
+        m_LentMapping = mapping;
+        m_LentMappingSize = size;
+
+        data = BufferView(static_cast<const Byte*>(mapping), size);
+
+        return true;
+      }
+
+      void StreamConnection::Shutdown()
+      {
+        m_Connected = false;
+
+        // the socket itself is closed on destruction only, a concurrent Send() must not use a reused file descriptor
+        shutdown(m_Socket.Get(), SHUT_RDWR);
+      }
+
+
+      StreamClientTransport::StreamClientTransport(int socket, bool receiveFiles, std::size_t fileThreshold, std::chrono::milliseconds receiveTimeout, IoEngineType ioEngine,
+                                                   std::chrono::milliseconds sendTimeout)
+      : Transport<InterfaceMode::Client>(), m_Connection(new StreamConnection(socket, fileThreshold, sendTimeout)), m_ReceiveTimeout(receiveTimeout), m_Engine(MakeIoEngine(ioEngine)), m_BufferPool()
+      {
+        StreamConnection* connection = m_Connection.get();
+
+        IoEngine::FileHandler fileHandler;
+
+        if (receiveFiles)
+        {
+          fileHandler = [connection] (int file) { connection->AppendFile(file); };
+        }
+
+        m_Engine->AddReceiver(connection->GetSocket(), [connection] (BufferView data) { connection->Append(data); }, fileHandler);
+      }
+
+      StreamClientTransport::~StreamClientTransport() noexcept = default;
+
+      void StreamClientTransport::Send(const Buffer& data)
+      {
+        m_Connection->Send(data);
+      }
+
+      void StreamClientTransport::Send(const Segments& segments)
+      {
+        m_Connection->Send(segments);
+      }
+
+      Buffer StreamClientTransport::Acquire()
+      {
+        return m_BufferPool.Acquire();
+      }
+
+      void StreamClientTransport::Commit(Buffer&& data)
+      {
+        m_Connection->Send(data);
+
+        // copied to the kernel, reuse the buffer
+        m_BufferPool.Recycle(std::move(data));
+      }
+
+      bool StreamClientTransport::Receive(Buffer& data)
+      {
+        return ReceiveFrame(data);
+      }
+
+      bool StreamClientTransport::ReceiveLent(BufferView& data)
+      {
+        return ReceiveFrame(data);
+      }
+
+      void StreamClientTransport::Return()
+      {
+        m_Connection->ReturnFrame();
+      }
+
+      void StreamClientTransport::Interrupt()
+      {
+        m_Engine->Interrupt();
+      }
+
+      template <typename Frame>
+      bool StreamClientTransport::ReceiveFrame(Frame& frame)
+      {
+        const auto deadline = GetReceiveDeadline(m_ReceiveTimeout);
+
+        for (;;)
+        {
+          if (m_Connection->ReadFrame(frame))
+          {
+            return true;
+          }
+
+          if (!m_Connection->IsConnected())
+          {
+            // frames already received were returned above
+            m_Engine->Remove(m_Connection->GetSocket());
+            m_Connection->Shutdown();
+
+            throw ExceptionImpl<TransportError>("Connection lost");
+          }
+
+          if (!m_Engine->Wait(deadline))
+          {
+            return false;
+          }
+        }
+      }
+
+
+      StreamServerTransport::StreamServerTransport(int listener, bool receiveFiles, std::size_t fileThreshold, std::chrono::milliseconds receiveTimeout, IoEngineType ioEngine,
+                                                   std::chrono::milliseconds sendTimeout)
+      : Transport<InterfaceMode::Server>(), m_Listener(listener), m_ReceiveFiles(receiveFiles), m_FileThreshold(fileThreshold), m_ReceiveTimeout(receiveTimeout), m_SendTimeout(sendTimeout),
+        m_ReserveFile(open("/dev/null", O_RDONLY | O_CLOEXEC)), m_AcceptTimer(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)), m_Engine(MakeIoEngine(ioEngine)), m_BufferPool(), m_Clients(), m_ClientsMutex(), m_ReadyClients(), m_LentClient(nullptr),
+        m_NextConnectionId(DefaultConnectionId + 1), m_LastConnectionId(DefaultConnectionId)
+      {
+        if (m_AcceptTimer.Get() < 0)
+        {
+          ThrowTransportError("Unable to create accept timer");
+        }
+
+        m_Engine->AddListener(m_Listener.Get(), [this] { Accept(); });
+      }
+
+      StreamServerTransport::~StreamServerTransport() noexcept = default;
+
+      std::size_t StreamServerTransport::GetConnectionCount() const
+      {
+        std::lock_guard<std::mutex> lock(m_ClientsMutex);
+
+        return m_Clients.size();
+      }
+
+      void StreamServerTransport::Send(const Buffer& data)
+      {
+        SendFrame(m_LastConnectionId.load(std::memory_order_relaxed), data);
+      }
+
+      void StreamServerTransport::Send(const Segments& segments)
+      {
+        SendFrame(m_LastConnectionId.load(std::memory_order_relaxed), segments);
+      }
+
+      void StreamServerTransport::SendTo(ConnectionId connection, const Segments& segments)
+      {
+        SendFrame(connection, segments);
+      }
+
+      Buffer StreamServerTransport::Acquire()
+      {
+        return m_BufferPool.Acquire();
+      }
+
+      void StreamServerTransport::Commit(Buffer&& data)
+      {
+        CommitTo(m_LastConnectionId.load(std::memory_order_relaxed), std::move(data));
+      }
+
+      void StreamServerTransport::CommitTo(ConnectionId connection, Buffer&& data)
+      {
+        SendFrame(connection, data);
+
+        // copied to the kernel, reuse the buffer
+        m_BufferPool.Recycle(std::move(data));
+      }
+
+      bool StreamServerTransport::Receive(Buffer& data)
+      {
+        return ReceiveFrame(data) != nullptr;
+      }
+
+      bool StreamServerTransport::ReceiveFrom(Buffer& data, ConnectionId& connection)
+      {
+        const Client* client = ReceiveFrame(data);
+
+        if (client == nullptr)
+        {
+          return false;
+        }
+
+        connection = client->m_Id;
+
+        return true;
+      }
+
+      bool StreamServerTransport::ReceiveLent(BufferView& data)
+      {
+        ConnectionId connection;
+
+        return ReceiveLentFrom(data, connection);
+      }
+
+      bool StreamServerTransport::ReceiveLentFrom(BufferView& data, ConnectionId& connection)
+      {
+        m_LentClient = ReceiveFrame(data);
+
+        if (m_LentClient == nullptr)
+        {
+          return false;
+        }
+
+        connection = m_LentClient->m_Id;
+
+        return true;
+      }
+
+      void StreamServerTransport::Return()
+      {
+        // clients are only disconnected by this thread while receiving, the one the frame was lent by is still alive
+        if (m_LentClient != nullptr)
+        {
+          m_LentClient->m_Connection.ReturnFrame();
+
+          m_LentClient = nullptr;
+        }
+      }
+
+      void StreamServerTransport::Interrupt()
+      {
+        m_Engine->Interrupt();
+      }
+
+      template <typename Data>
+      void StreamServerTransport::SendFrame(ConnectionId connection, const Data& data)
+      {
+        std::shared_ptr<Client> client;
+
+        {
+          std::lock_guard<std::mutex> lock(m_ClientsMutex);
+
+          auto clientIter = m_Clients.find(connection);
+
+          if (clientIter != m_Clients.end())
+          {
+            client = clientIter->second;
+          }
+        }
+
+        if (!client)
+        {
+          // TODO: add trace / logging
+          return;
+        }
+
+        try
+        {
+          client->m_Connection.Send(data);
+        }
+
+        catch (const TransportError&)
+        {
+          // client is gone, detected and cleaned up by Receive()
+          // TODO: add trace / logging
+        }
+      }
+
+      template <typename Frame>
+      StreamServerTransport::Client* StreamServerTransport::ReceiveFrame(Frame& frame)
+      {
+        const auto deadline = GetReceiveDeadline(m_ReceiveTimeout);
+
+        for (;;)
+        {
+          // only clients that received something since they were read last are looked at, idle ones cost nothing
+          while (!m_ReadyClients.empty())
+          {
+            Client* client = m_ReadyClients.front();
+
+            m_ReadyClients.pop_front();
+
+            if (client->m_Connection.ReadFrame(frame))
+            {
+              // further frames may be buffered already, the client queues up again behind the other ready ones
+              m_ReadyClients.push_back(client);
+
+              m_LastConnectionId.store(client->m_Id, std::memory_order_relaxed);
+
+              return client;
+            }
+
+            client->m_Ready = false;
+
+            if (!client->m_Connection.IsConnected())
+            {
+              Disconnect(*client);
+            }
+          }
+
+          if (!m_Engine->Wait(deadline))
+          {
+            return nullptr;
+          }
+        }
+      }
+
+      void StreamServerTransport::Accept()
+      {
+        // all pending connections at once, the listener is not reported again for connections already waiting
+        for (;;)
+        {
+          FileDescriptor socket(accept4(m_Listener.Get(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC));
+
+          if (socket.Get() < 0)
+          {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+              // no further pending connections
+              return;
+            }
+
+            if ((errno == EINTR) || (errno == ECONNABORTED))
+            {
+              // client gave up meanwhile
+              continue;
+            }
+
+            if (((errno == EMFILE) || (errno == ENFILE)) && (m_ReserveFile.Get() >= 0))
+            {
+              // out of file descriptors, the client is rejected (closed) instead of being left pending with the listener readable
+              // TODO: add trace / logging
+              m_ReserveFile.Reset();
+
+              FileDescriptor rejected(accept4(m_Listener.Get(), nullptr, nullptr, SOCK_CLOEXEC));
+              const bool pending = rejected.Get() >= 0;
+
+              rejected.Reset();
+
+              m_ReserveFile.Reset(open("/dev/null", O_RDONLY | O_CLOEXEC));
+
+              // accept4() reports EMFILE even if no connection is pending
+              if (!pending)
+              {
+                return;
+              }
+
+              continue;
+            }
+
+            // unable to reject the client either (e.g. out of memory), try again later
+            // TODO: add trace / logging
+            PauseAccept();
+
+            return;
+          }
+
+          auto client = std::make_shared<Client>(m_NextConnectionId++, socket.Release(), m_FileThreshold, m_SendTimeout);
+
+          {
+            std::lock_guard<std::mutex> lock(m_ClientsMutex);
+
+            m_Clients.emplace(client->m_Id, client);
+          }
+
+          // handlers are removed before the client is released, see Disconnect()
+          Client* receiver = client.get();
+
+          IoEngine::FileHandler fileHandler;
+
+          if (m_ReceiveFiles)
+          {
+            fileHandler = [receiver] (int file) { receiver->m_Connection.AppendFile(file); };
+          }
+
+          m_Engine->AddReceiver(receiver->m_Connection.GetSocket(), [this, receiver] (BufferView data) { Append(*receiver, data); }, fileHandler);
+        }
+      }
+
+      void StreamServerTransport::PauseAccept()
+      {
+        itimerspec delay = {};
+
+        delay.it_value.tv_sec = AcceptRetryDelayMs / 1000;
+        delay.it_value.tv_nsec = (AcceptRetryDelayMs % 1000) * 1000000;
+
+        if (timerfd_settime(m_AcceptTimer.Get(), 0, &delay, nullptr) != 0)
+        {
+          // keep accepting (and retrying) rather than never again
+          // TODO: add trace / logging
+          return;
+        }
+
+        // called from within the handler of the listener
+        m_Engine->Remove(m_Listener.Get());
+        m_Engine->AddListener(m_AcceptTimer.Get(), [this] { ResumeAccept(); });
+      }
+
+      void StreamServerTransport::ResumeAccept()
+      {
+        std::uint64_t expirations = 0;
+
+        if (read(m_AcceptTimer.Get(), &expirations, sizeof(expirations)) < 0)
+        {
+          // TODO: add trace / logging
+        }
+
+        m_Engine->Remove(m_AcceptTimer.Get());
+        m_Engine->AddListener(m_Listener.Get(), [this] { Accept(); });
+      }
+
+      void StreamServerTransport::Append(Client& client, BufferView data)
+      {
+        client.m_Connection.Append(data);
+
+        // a closed connection is ready as well, it is disconnected once its last frame was read
+        if (!client.m_Ready)
+        {
+          client.m_Ready = true;
+
+          m_ReadyClients.push_back(&client);
+        }
+      }
+
+      void StreamServerTransport::Disconnect(Client& client)
+      {
+        assert(!client.m_Ready && (&client != m_LentClient));
+
+        m_Engine->Remove(client.m_Connection.GetSocket());
+
+        client.m_Connection.Shutdown();
+
+        // released here unless a concurrent Send() still uses it
+        std::lock_guard<std::mutex> lock(m_ClientsMutex);
+
+        m_Clients.erase(client.m_Id);
+      }
+
+    }  // namespace Detail
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
@@ -0,0 +1,243 @@
+#ifndef CPPRPC_STREAMTRANSPORT_H
+#define CPPRPC_STREAMTRANSPORT_H
+
+#pragma once
+
+// stream socket transports are built on epoll / io_uring, Linux only for now
+#if defined(__linux__)
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+
+#include <boost/noncopyable.hpp>
+
+#include "cpprpc/Types.h"
+#include "cpprpc/Transport.h"
+#include "cpprpc/IoEngine.h"
+
+struct msghdr;
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    // maximum size of a single frame, bigger frames are treated as protocol errors
+    const std::size_t StreamMaxFrameSize = 256 * 1024 * 1024;
+
+    // a send fails (and the connection is closed) if the peer does not take any data for this long, the socket buffer being full
+    const std::chrono::milliseconds StreamDefaultSendTimeout = std::chrono::seconds(10);
+
+    namespace Detail
+    {
+
+      // non-blocking stream socket connection, every frame is prefixed by its size (32 bit, little endian)
+      //
+      // frames of at least fileThreshold bytes are not sent through the socket but handed over as a sealed memfd (SCM_RIGHTS),
+      // for Unix domain sockets only, 0 disables the hand-off
+      class StreamConnection : boost::noncopyable
+      {
+        public:
+          StreamConnection(int socket, std::size_t fileThreshold, std::chrono::milliseconds sendTimeout);  // takes ownership of socket
+          ~StreamConnection();
+
+          int GetSocket() const { return m_Socket.Get(); }
+
+          bool IsConnected() const { return m_Connected; }
+
+          // thread safe, returns after the whole frame was handed to the kernel, throws TransportError if not connected (anymore);
+          // closes the connection (and throws) if the peer did not take any data within the send timeout
+          void Send(BufferView data);
+
+          // thread safe, segments are gathered into one frame by the kernel
+          void Send(const std::vector<BufferView>& segments);
+
+          // adds data received by the I/O engine, an empty view marks the connection as closed (see IoEngine::ReceiveHandler)
+          void Append(BufferView data);
+
+          // adds a file received by the I/O engine (see IoEngine::FileHandler), used by the next frame handed over as file;
+          // closes the file and the connection if the peer sent more files than file frames
+          void AppendFile(int file);
+
+          // returns the next complete frame received so far, if any
+          bool ReadFrame(Buffer& data);
+
+          // frame is lent in place (in the receive buffer or the mapped file) until ReturnFrame()
+          bool ReadFrame(BufferView& data);
+          void ReturnFrame();
+
+          // no further sends, waking up the peer
+          void Shutdown();
+
+        private:
+          FileDescriptor                  m_Socket;
+          const std::size_t               m_FileThreshold;
+          const std::chrono::milliseconds m_SendTimeout;
+          std::atomic<bool>               m_Connected;
+          std::mutex        m_SendMutex;
+
+          // only used by the receiving thread
+          Buffer           m_ReceiveBuffer;
+          std::size_t      m_ReceivePosition;  // start of the first incomplete frame in m_ReceiveBuffer
+          std::vector<int> m_ReceivedFiles;    // rarely more than one, unlike a deque no allocation while empty
+          void*            m_LentMapping;      // mapped file of the lent frame, if any
+          std::size_t      m_LentMappingSize;
+
+          void SendFrame(const BufferView* segments, std::size_t segmentCount);
+          void SendFile(const BufferView* segments, std::size_t segmentCount, std::size_t size);
+          void SendMessage(msghdr& message);
+          bool MapFile(std::size_t size, BufferView& data);
+
+          // size prefixes of frames handed over as file received but not read yet
+          std::size_t CountFileFrames() const;
+      };
+
+
+      // client side of a stream socket transport
+      class StreamClientTransport : public Transport<InterfaceMode::Client>
+      {
+        public:
+          virtual ~StreamClientTransport() noexcept override;
+
+          IoEngineType GetIoEngineType() const { return m_Engine->GetType(); }
+
+          using Transport<InterfaceMode::Client>::Send;
+
+          // throws TransportError if the connection is lost
+          virtual void Send(const Buffer& data) override;
+          virtual void Send(const Segments& segments) override;
+
+          virtual Buffer Acquire() override;
+          virtual void Commit(Buffer&& data) override;
+
+          // returns false after the timeout expired or if interrupted, throws TransportError once the connection is lost (and all frames were read)
+          virtual bool Receive(Buffer& data) override;
+
+          virtual bool ReceiveLent(BufferView& data) override;
+          virtual void Return() override;
+
+          virtual void Interrupt() override;
+
+        protected:
+          // takes ownership of the connected socket, receiveFiles if the socket supports SCM_RIGHTS
+          StreamClientTransport(int socket, bool receiveFiles, std::size_t fileThreshold, std::chrono::milliseconds receiveTimeout, IoEngineType ioEngine,
+                                std::chrono::milliseconds sendTimeout);
+
+        private:
+          std::unique_ptr<StreamConnection> m_Connection;
+          std::chrono::milliseconds         m_ReceiveTimeout;
+          std::unique_ptr<IoEngine>         m_Engine;
+          BufferPool                        m_BufferPool;
+
+          template <typename Frame>
+          bool ReceiveFrame(Frame& frame);
+      };
+
+
+      // server side of a stream socket transport, serves any number of connections at once, all of them are multiplexed over the I/O engine
+      // driven by the receiving thread
+      class StreamServerTransport : public Transport<InterfaceMode::Server>
+      {
+        public:
+          virtual ~StreamServerTransport() noexcept override;
+
+          IoEngineType GetIoEngineType() const { return m_Engine->GetType(); }
+
+          // thread safe, number of clients currently connected (as far as seen by the receiving thread)
+          std::size_t GetConnectionCount() const;
+
+          using Transport<InterfaceMode::Server>::Send;
+
+          // results for a client that already disconnected are dropped
+          virtual void Send(const Buffer& data) override;
+          virtual void Send(const Segments& segments) override;
+          virtual void SendTo(ConnectionId connection, const Segments& segments) override;
+
+          virtual Buffer Acquire() override;
+          virtual void Commit(Buffer&& data) override;
+          virtual void CommitTo(ConnectionId connection, Buffer&& data) override;
+
+          // accepts new connections meanwhile, returns false after the timeout expired or if interrupted
+          virtual bool Receive(Buffer& data) override;
+          virtual bool ReceiveFrom(Buffer& data, ConnectionId& connection) override;
+
+          virtual bool ReceiveLent(BufferView& data) override;
+          virtual bool ReceiveLentFrom(BufferView& data, ConnectionId& connection) override;
+          virtual void Return() override;
+
+          virtual void Interrupt() override;
+
+        protected:
+          // takes ownership of the listening socket, receiveFiles if its connections support SCM_RIGHTS
+          StreamServerTransport(int listener, bool receiveFiles, std::size_t fileThreshold, std::chrono::milliseconds receiveTimeout, IoEngineType ioEngine,
+                                std::chrono::milliseconds sendTimeout);
+
+          int GetListener() const { return m_Listener.Get(); }
+
+        private:
+          struct Client : boost::noncopyable
+          {
+            Client(ConnectionId id, int socket, std::size_t fileThreshold, std::chrono::milliseconds sendTimeout)
+            : m_Id(id), m_Connection(socket, fileThreshold, sendTimeout), m_Ready(false)
+            {}
+
+            const ConnectionId m_Id;
+            StreamConnection   m_Connection;
+            bool               m_Ready;  // receiving thread only, queued in m_ReadyClients
+          };
+
+          using Clients = std::unordered_map<ConnectionId, std::shared_ptr<Client>>;
+
+          FileDescriptor            m_Listener;
+          const bool                m_ReceiveFiles;
+          const std::size_t         m_FileThreshold;
+          std::chrono::milliseconds m_ReceiveTimeout;
+          std::chrono::milliseconds m_SendTimeout;
+          FileDescriptor            m_ReserveFile;  // given up to accept (and close) a connection once out of file descriptors, see Accept()
+          FileDescriptor            m_AcceptTimer;  // timerfd, resumes accepting after it was paused, see PauseAccept()
+          std::unique_ptr<IoEngine> m_Engine;
+          BufferPool                m_BufferPool;
+
+          Clients            m_Clients;       // changed by the receiving thread only
+          mutable std::mutex m_ClientsMutex;  // guards m_Clients against concurrent Send()
+
+          // only used by the receiving thread
+          std::deque<Client*> m_ReadyClients;  // received data not read yet, served round-robin
+          Client*             m_LentClient;    // client of the lent frame, if any
+          ConnectionId        m_NextConnectionId;
+
+          std::atomic<ConnectionId> m_LastConnectionId;  // client of the message received last, see Send()
+
+          void Accept();
+          void Disconnect(Client& client);
+
+          // stops watching the listener for a while, it would be reported readable over and over while connections can not be accepted
+          void PauseAccept();
+          void ResumeAccept();
+
+          // called by the I/O engine for every chunk received
+          void Append(Client& client, BufferView data);
+
+          // sends to the connection, if it is still connected
+          template <typename Data>
+          void SendFrame(ConnectionId connection, const Data& data);
+
+          // returns the client the frame was read from, nullptr after the timeout expired or if interrupted
+          template <typename Frame>
+          Client* ReceiveFrame(Frame& frame);
+      };
+
+    }  // namespace Detail
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
+
+#endif
@@ -0,0 +1,164 @@
+#include "cpprpc/TcpTransport.h"
+
+#if defined(__linux__)
+
+#include <memory>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <fcntl.h>
+
+#include <boost/format.hpp>
+
+#include "cpprpc/Exception.h"
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    namespace
+    {
+
+      using Detail::ThrowTransportError;
+
+      void SetNoDelay(int socket)
+      {
+        const int enable = 1;
+
+        if (setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable)) != 0)
+        {
+          ThrowTransportError("Unable to set TCP_NODELAY");
+        }
+      }
+
+      struct AddressInfoDeleter
+      {
+        void operator()(addrinfo* info) const
+        {
+          freeaddrinfo(info);
+        }
+      };
+
+      using AddressInfo = std::unique_ptr<addrinfo, AddressInfoDeleter>;
+
+      AddressInfo GetAddressInfo(const std::string& host, std::uint16_t port, int flags)
+      {
+        addrinfo hints = {};
+
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = flags;
+
+        addrinfo* info = nullptr;
+
+        const int error = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &info);
+
+        if (error != 0)
+        {
+          throw Detail::ExceptionImpl<TransportError>((boost::format("Unable to resolve \"%1%:%2%\": %3%") % host % port % gai_strerror(error)).str());
+        }
+
+        return AddressInfo(info);
+      }
+
+      // returns non-blocking socket connected to the first address of host we are able to connect to
+      int Connect(const std::string& host, std::uint16_t port)
+      {
+        const AddressInfo addresses = GetAddressInfo(host, port, 0);
+
+        for (const addrinfo* address = addresses.get(); address != nullptr; address = address->ai_next)
+        {
+          Detail::FileDescriptor socket(::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol));
+
+          if ((socket.Get() >= 0) && (connect(socket.Get(), address->ai_addr, address->ai_addrlen) == 0))
+          {
+            SetNoDelay(socket.Get());
+
+            // switch to non-blocking after connecting
+            const int flags = fcntl(socket.Get(), F_GETFL);
+
+            if ((flags < 0) || (fcntl(socket.Get(), F_SETFL, flags | O_NONBLOCK) != 0))
+            {
+              ThrowTransportError("Unable to make socket non-blocking");
+            }
+
+            return socket.Release();
+          }
+        }
+
+        ThrowTransportError((boost::format("Unable to connect to \"%1%:%2%\"") % host % port).str());
+      }
+
+      // returns non-blocking socket listening on address:port, shared with other sockets (SO_REUSEPORT) if sharedPort
+      int Listen(const std::string& address, std::uint16_t port, bool sharedPort)
+      {
+        const AddressInfo addresses = GetAddressInfo(address, port, AI_PASSIVE | AI_NUMERICHOST);
+
+        Detail::FileDescriptor listener(socket(addresses->ai_family, addresses->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, addresses->ai_protocol));
+
+        if (listener.Get() < 0)
+        {
+          ThrowTransportError("Unable to create socket");
+        }
+
+        const int enable = 1;
+
+        setsockopt(listener.Get(), SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+        if (sharedPort && (setsockopt(listener.Get(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) != 0))
+        {
+          ThrowTransportError("Unable to share port");
+        }
+
+        // inherited by accepted connections
+        SetNoDelay(listener.Get());
+
+        if (bind(listener.Get(), addresses->ai_addr, addresses->ai_addrlen) != 0)
+        {
+          ThrowTransportError((boost::format("Unable to bind to \"%1%:%2%\"") % address % port).str());
+        }
+
+        if (listen(listener.Get(), SOMAXCONN) != 0)
+        {
+          ThrowTransportError("Unable to listen");
+        }
+
+        return listener.Release();
+      }
+
+      // port actually bound to (port 0)
+      std::uint16_t GetBoundPort(int listener)
+      {
+        sockaddr_storage boundAddress = {};
+        socklen_t boundAddressSize = sizeof(boundAddress);
+
+        if (getsockname(listener, reinterpret_cast<sockaddr*>(&boundAddress), &boundAddressSize) != 0)
+        {
+          ThrowTransportError("Unable to get bound address");
+        }
+
+        return ntohs((boundAddress.ss_family == AF_INET6) ? reinterpret_cast<sockaddr_in6&>(boundAddress).sin6_port : reinterpret_cast<sockaddr_in&>(boundAddress).sin_port);
+      }
+
+    }  // anonymous namespace
+
+
+    TcpClientTransport::TcpClientTransport(const std::string& host, std::uint16_t port, std::chrono::milliseconds receiveTimeout, IoEngineType ioEngine,
+                                           std::chrono::milliseconds sendTimeout)
+    : Detail::StreamClientTransport(Connect(host, port), false, 0, receiveTimeout, ioEngine, sendTimeout)
+    {}
+
+
+    TcpServerTransport::TcpServerTransport(std::uint16_t port, const std::string& address, std::chrono::milliseconds receiveTimeout, IoEngineType ioEngine, bool sharedPort,
+                                           std::chrono::milliseconds sendTimeout)
+    : Detail::StreamServerTransport(Listen(address, port, sharedPort), false, 0, receiveTimeout, ioEngine, sendTimeout), m_Port(GetBoundPort(GetListener()))
+    {}
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
@@ -0,0 +1,57 @@
+#ifndef CPPRPC_TCPTRANSPORT_H
+#define CPPRPC_TCPTRANSPORT_H
+
+#pragma once
+
+// TCP transport is built on epoll / io_uring, Linux only for now
+#if defined(__linux__)
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+#include "cpprpc/StreamTransport.h"
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    const std::chrono::milliseconds TcpDefaultReceiveTimeout = InfiniteReceiveTimeout;
+    const std::chrono::milliseconds TcpDefaultSendTimeout = StreamDefaultSendTimeout;
+
+
+    // connects to a TcpServerTransport on construction
+    class TcpClientTransport : public Detail::StreamClientTransport
+    {
+      public:
+        TcpClientTransport(const std::string& host, std::uint16_t port, std::chrono::milliseconds receiveTimeout = TcpDefaultReceiveTimeout, IoEngineType ioEngine = IoEngineType::Automatic,
+                           std::chrono::milliseconds sendTimeout = TcpDefaultSendTimeout);
+
+        virtual ~TcpClientTransport() noexcept override = default;
+    };
+
+
+    // listens on address:port, serves any number of connections at once
+    class TcpServerTransport : public Detail::StreamServerTransport
+    {
+      public:
+        // port 0 picks a free port, see GetPort(); sharedPort lets further transports listen on the same port (all of them need it),
+        // new connections are distributed between them by the kernel, e.g. to the shards of a ServerMode::ShardPerCore dispatcher
+        explicit TcpServerTransport(std::uint16_t port, const std::string& address = "0.0.0.0", std::chrono::milliseconds receiveTimeout = TcpDefaultReceiveTimeout,
+                                    IoEngineType ioEngine = IoEngineType::Automatic, bool sharedPort = false, std::chrono::milliseconds sendTimeout = TcpDefaultSendTimeout);
+
+        virtual ~TcpServerTransport() noexcept override = default;
+
+        std::uint16_t GetPort() const { return m_Port; }
+
+      private:
+        std::uint16_t m_Port;
+    };
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
+
+#endif
@@ -1,15 +1,81 @@
 #include "cpprpc/Interface.h"
+#include "cpprpc/StaticInterface.h"
+#include "cpprpc/TcpTransport.h"
+#include "cpprpc/SharedMemoryTransport.h"
+#include "cpprpc/UnixTransport.h"
 
 #include <string>
 #include <functional>
 #include <map>
 #include <list>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
+#include <cassert>
 
 #include <boost/serialization/map.hpp>
 #include <boost/serialization/list.hpp>
+#include <boost/mpl/vector.hpp>
 #include <boost/format.hpp>
 
+#if defined(__linux__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+
+// trivially copyable without padding, written as raw bytes by the binary serializer
+struct TestSample
+{
+  std::int32_t m_X;
+  std::int32_t m_Y;
+  double       m_Value;
+};
+
+BOOST_IS_BITWISE_SERIALIZABLE(TestSample)
+
+// the compiler can not prove it for the double member
+namespace CppRpc
+{
+  template <>
+  struct IsPaddingFree<TestSample> : std::true_type {};
+}
+
+// padded, written by serialize() instead, the padding bytes must not go onto the wire
+struct TestPaddedSample
+{
+  std::uint8_t  m_Tag;
+  std::uint32_t m_Value;
+
+  template <typename Archive>
+  void serialize(Archive& ar, const unsigned int /*version*/)
+  {
+    ar & m_Tag & m_Value;
+  }
+};
+
+BOOST_IS_BITWISE_SERIALIZABLE(TestPaddedSample)
+
+// padded without serialize(), still written as raw bytes (padding included) as there is no other way to write it
+struct TestRawPaddedSample
+{
+  std::uint8_t  m_Tag;
+  std::uint32_t m_Value;
+};
+
+BOOST_IS_BITWISE_SERIALIZABLE(TestRawPaddedSample)
+
 
 struct TestImplementation
 {
@@ -18,6 +84,7 @@ struct TestImplementation
   static int  TestFunc3(int i) { return i; }
   static bool TestFunc4(const std::string& str) { return !str.empty(); }
   static bool TestFunc5(const std::string& str, bool enable) { return enable ? !str.empty() : false; }
+  static void TestFunc7(int i) { TestFunc7Value = i; }  // one-way
 
 
   template <typename Key1, typename Key2, typename Value>
@@ -31,11 +98,15 @@ struct TestImplementation
 
   static TestFunc6ReturnType TestFunc6(const TestFunc6ParamType& input);
 
+  static std::atomic<int> TestFunc7Value;
+
   static const CppRpc::Name Name;
 };
 
 const CppRpc::Name TestImplementation::Name = {"TestImplementation"};
 
+std::atomic<int> TestImplementation::TestFunc7Value(0);
+
 TestImplementation::TestFunc6ReturnType TestImplementation::TestFunc6(const TestFunc6ParamType& input)
 {
   TestFunc6ReturnType result;
@@ -70,12 +141,14 @@ struct TestImplementation_Throws
   using TestFunc4Exception = Exception<4>;
   using TestFunc5Exception = Exception<5>;
   using TestFunc6Exception = Exception<6>;
+  using TestFunc7Exception = Exception<7>;
 
   static void TestFunc1() { throw TestFunc1Exception(); }
   static int  TestFunc2() { throw TestFunc2Exception(); }
   static int  TestFunc3(int /*i*/) { throw TestFunc3Exception(); }
   static bool TestFunc4(const std::string& /*str*/) { throw TestFunc4Exception(); }
   static bool TestFunc5(const std::string& /*str*/, bool /*enable*/) { throw TestFunc5Exception(); }
+  static void TestFunc7(int /*i*/) { throw TestFunc7Exception(); }
 
 
   template <typename Key1, typename Key2, typename Value>
@@ -100,7 +173,9 @@ template <typename Implementation, CppRpc::InterfaceMode Mode>
 class Interface : public CppRpc::Interface<Mode>
 {
   public:
-    
+    template <typename T>
+    using Function = typename CppRpc::Interface<Mode>::template Function<T>;
+
     template <typename Argument>
     Interface(Argument&& argument)
     : CppRpc::Interface<Mode>(std::forward<Argument>(argument), Implementation::Name, {1, 1})
@@ -109,14 +184,17 @@ class Interface : public CppRpc::Interface<Mode>
     // setup callable functions
     Function<void(void)>                     TestFunc1 = {*this, "TestFunc1", &Implementation::TestFunc1};
     Function<int(void)>                      TestFunc2 = {*this, "TestFunc2", std::function<int(void)>(&Implementation::TestFunc2)};  // test std::function object
-    Function<int(int)>                       TestFunc3 = {*this, "TestFunc3", [] (int i) { return Implementation::TestFunc3(i); }};   // test lambda function
-    Function<bool(const std::string&)>       TestFunc4 = {*this, "TestFunc4", &Implementation::TestFunc4};
+    Function<int(int)>                       TestFunc3 = {*this, "TestFunc3", [] (int i) { return Implementation::TestFunc3(i); }, CppRpc::ExecutionPolicy::Inline};   // test lambda function
+    Function<bool(const std::string&)>       TestFunc4 = {*this, "TestFunc4", &Implementation::TestFunc4, CppRpc::ExecutionPolicy::Adaptive};
     Function<bool(const std::string&, bool)> TestFunc5 = {*this, "TestFunc5", &Implementation::TestFunc5};
 
-    Function<typename Implementation::TestFunc6ReturnType(typename const Implementation::TestFunc6ParamType&)> TestFunc6 = {*this, "TestFunc6", &Implementation::TestFunc6};
+    Function<typename Implementation::TestFunc6ReturnType(const typename Implementation::TestFunc6ParamType&)> TestFunc6 = {*this, "TestFunc6", &Implementation::TestFunc6};
+
+    Function<void(int)>                      TestFunc7 = {*this, "TestFunc7", &Implementation::TestFunc7, CppRpc::OneWay};
     
 
     //Function<std::function<void(void)>> TestFuncBad = {*this, "TestFunc1", &Implementation::TestFunc1};  // must not compile (T must be a function type, static assert)
+    //Function<int(void)> TestFuncBad = {*this, "TestFunc2", &Implementation::TestFunc2, CppRpc::OneWay};  // must not compile (one-way functions must not return a value, static assert)
 };
 
 
@@ -134,48 +212,1386 @@ using TestServerThrows = TestInterfaceThrows<CppRpc::InterfaceMode::Server>;
 using TestClientThrows = TestInterfaceThrows<CppRpc::InterfaceMode::Client>;
 
 
-int main()
+template <typename Serializer>
+void TestSerializer()
 {
-  CppRpc::V1::LocalDummyTransport transport;
+  TestImplementation::TestFunc6ParamType data;
 
-  TestServer::DispatcherHandle serverDispatcher = CppRpc::V1::MakeDispatcherHandle(transport.GetServerTransport());
+  data[4711] = {"Hallo", "World!"};
+  data[815] = {"this", "is", "almost", "magic"};
+  data[0] = {};
+
+  CppRpc::Buffer buffer;
+
+  {
+    typename Serializer::OArchive archive(buffer);
+
+    archive << data << std::string("foo") << 42 << true;
+  }
+
+  TestImplementation::TestFunc6ParamType result;
+  std::string str;
+  int i = 0;
+  bool b = false;
+
+  {
+    typename Serializer::IArchive archive(buffer);
+
+    archive >> result >> str >> i >> b;
+  }
+
+  assert(result == data);
+  assert(str == "foo");
+  assert(i == 42);
+  assert(b);
+}
+
+// contiguous containers of trivially copyable types are copied as one block
+void TestBulkSerialization()
+{
+  enum class Channel : std::uint16_t { Left = 1, Right = 2 };
+
+  std::vector<double> samples(1000);
+  std::iota(samples.begin(), samples.end(), 0.5);
+
+  const std::vector<Channel> channels = {Channel::Left, Channel::Right, Channel::Left};
+  const std::array<std::int32_t, 3> offsets = {{-1, 0, 4711}};
+  const std::vector<TestSample> structs = {{1, 2, 3.5}, {4, 5, 6.5}};
+  const TestSample single = {7, 8, 9.5};
+
+  CppRpc::Buffer buffer;
+
+  {
+    CppRpc::BinarySerializer::OArchive archive(buffer);
+
+    archive << samples << channels << offsets << structs << single;
+  }
+
+  // same size as written element by element (sizes are LEB128 encoded)
+  assert(buffer.size() == (2 + samples.size() * sizeof(double)) + (1 + channels.size() * sizeof(Channel)) + sizeof(offsets) + (1 + 3 * sizeof(TestSample)));
+
+  std::vector<double> samplesResult;
+  std::vector<Channel> channelsResult;
+  std::array<std::int32_t, 3> offsetsResult = {};
+  std::vector<TestSample> structsResult;
+  TestSample singleResult = {};
+
+  {
+    CppRpc::BinarySerializer::IArchive archive(buffer);
+
+    archive >> samplesResult >> channelsResult >> offsetsResult >> structsResult >> singleResult;
+  }
+
+  assert(samplesResult == samples);
+  assert(channelsResult == channels);
+  assert(offsetsResult == offsets);
+  assert((structsResult.size() == 2) && (structsResult[1].m_Y == 5) && (structsResult[1].m_Value == 6.5));
+  assert((singleResult.m_X == 7) && (singleResult.m_Value == 9.5));
+
+  // element count exceeding the remaining data is rejected before allocating
+  bool thrown = false;
+
+  try
+  {
+    CppRpc::BinarySerializer::IArchive archive(CppRpc::BufferView(buffer.data(), 100));
+
+    archive >> samplesResult;
+  }
+
+  catch (const CppRpc::MalformedMessage&)
+  {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  // padding filled with garbage is not written, same encoding as element by element
+  static_assert(CppRpc::Detail::IsBitwiseObject<TestSample>::value, "types declared padding free are written as raw bytes");
+  static_assert(!CppRpc::Detail::IsBitwiseObject<TestPaddedSample>::value, "padded types with serialize() must not be written as raw bytes");
+  static_assert(CppRpc::Detail::IsBitwiseObject<TestRawPaddedSample>::value, "padded types without serialize() are written as raw bytes");
+
+  std::vector<TestPaddedSample> padded(2);
+  std::memset(padded.data(), 0xaa, padded.size() * sizeof(TestPaddedSample));
+
+  padded[0].m_Tag = 1;
+  padded[0].m_Value = 2;
+  padded[1].m_Tag = 3;
+  padded[1].m_Value = 4;
+
+  buffer.clear();
+
+  {
+    CppRpc::BinarySerializer::OArchive archive(buffer);
+
+    archive << padded;
+  }
+
+  assert(buffer.size() == 1 + 2 * (sizeof(std::uint8_t) + sizeof(std::uint32_t)));
+  assert(std::find(buffer.begin(), buffer.end(), 0xaa) == buffer.end());
+
+  std::vector<TestPaddedSample> paddedResult;
+
+  {
+    CppRpc::BinarySerializer::IArchive archive(buffer);
+
+    archive >> paddedResult;
+  }
+
+  assert((paddedResult.size() == 2) && (paddedResult[1].m_Tag == 3) && (paddedResult[1].m_Value == 4));
+
+  const TestRawPaddedSample raw = {5, 6};
+
+  buffer.clear();
+
+  {
+    CppRpc::BinarySerializer::OArchive archive(buffer);
+
+    archive << raw;
+  }
+
+  assert(buffer.size() == sizeof(TestRawPaddedSample));
+
+  TestRawPaddedSample rawResult = {};
+
+  {
+    CppRpc::BinarySerializer::IArchive archive(buffer);
+
+    archive >> rawResult;
+  }
+
+  assert((rawResult.m_Tag == 5) && (rawResult.m_Value == 6));
+}
+
+// inline and heap storage, slices sharing the data of a buffer
+void TestBuffer()
+{
+  CppRpc::Buffer small = {1, 2, 3};
+  CppRpc::Buffer big(CppRpc::Buffer::InlineCapacity * 4, 42);
+
+  assert(small.capacity() == CppRpc::Buffer::InlineCapacity);
+  assert(big.capacity() >= big.size());
+
+  small.insert(small.begin() + 1, big.begin(), big.end());
+  small.erase(small.begin() + 1, small.end() - 2);
+  assert((small == CppRpc::Buffer{1, 2, 3}));
+
+  CppRpc::Buffer moved(std::move(big));
+  assert(big.empty() && (moved.size() == CppRpc::Buffer::InlineCapacity * 4));
+
+  const CppRpc::BufferSlice inlineSlice = small.Slice(1, 2);
+  const CppRpc::BufferSlice heapSlice = moved.Slice(10, 20);
+
+  // modifying or destroying the buffers leaves the slices alone
+  small.push_back(4);
+  small[0] = 0;
+  moved.clear();
+  small = CppRpc::Buffer();
+
+  assert((inlineSlice.size() == 2) && (inlineSlice.data()[0] == 2) && (inlineSlice.data()[1] == 3));
+  assert((heapSlice.size() == 20) && std::all_of(heapSlice.begin(), heapSlice.end(), [] (CppRpc::Byte b) { return b == 42; }));
+}
+
+// exercises the transport API directly, before any dispatcher receives from the transports
+void TestTransport(CppRpc::Transport<CppRpc::InterfaceMode::Server>& serverTransport, CppRpc::Transport<CppRpc::InterfaceMode::Client>& clientTransport, std::size_t payloadSize)
+{
+  const CppRpc::Buffer header = {1, 2, 3};
+  const CppRpc::Buffer payload(payloadSize, 42);
+
+  CppRpc::Buffer data;
+  CppRpc::BufferView lent;
+
+  // segments arrive as one message
+  clientTransport.Send(CppRpc::Transport<CppRpc::InterfaceMode::Client>::Segments{header, payload});
+
+  while (!serverTransport.Receive(data))
+  {}
+
+  assert(data.size() == header.size() + payload.size());
+  assert(std::equal(header.begin(), header.end(), data.begin()));
+  assert(std::equal(payload.begin(), payload.end(), data.begin() + header.size()));
+
+  // serialized into a buffer of the transport, received in place
+  data = serverTransport.Acquire();
+  assert(data.empty());
+
+  data.assign(payload.begin(), payload.end());
+
+  serverTransport.Commit(std::move(data));
+
+  while (!clientTransport.ReceiveLent(lent))
+  {}
+
+  assert((lent.size() == payload.size()) && std::equal(payload.begin(), payload.end(), lent.begin()));
+
+  clientTransport.Return();
+
+  // moved into the transport
+  data = header;
+
+  clientTransport.Send(std::move(data));
+
+  while (!serverTransport.ReceiveLent(lent))
+  {}
+
+  assert((lent.size() == header.size()) && std::equal(header.begin(), header.end(), lent.begin()));
+
+  serverTransport.Return();
+
+  // interrupt is kept until the next receive, which returns right away
+  serverTransport.Interrupt();
+  assert(!serverTransport.Receive(data));
+
+  clientTransport.Interrupt();
+  assert(!clientTransport.ReceiveLent(lent));
+
+  // blocked receive is woken up
+  std::thread receiver([&serverTransport]
+    {
+      CppRpc::Buffer received;
+
+      const bool b = serverTransport.Receive(received);
+      assert(!b);
+    });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  serverTransport.Interrupt();
+
+  receiver.join();
+}
+
+
+#ifdef CPPRPC_HAS_COROUTINES
+// minimal eagerly started coroutine, signals completion through a future
+struct TestCoroutine
+{
+  struct promise_type
+  {
+    std::promise<void> m_Done;
+
+    TestCoroutine get_return_object() { return {m_Done.get_future()}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() { m_Done.set_value(); }
+    void unhandled_exception() { m_Done.set_exception(std::current_exception()); }
+  };
+
+  std::future<void> m_Done;
+};
+
+TestCoroutine TestAwait(TestClient& client)
+{
+  int i = co_await client.TestFunc3.AsyncCall(4711);
+  assert(i == 4711);
+
+  bool b = co_await client.TestFunc4.AsyncCall("Hallo");
+  assert(b);
+
+  co_await client.TestFunc1.AsyncCall();
+}
+#endif
+
+
+// with worker threads, inline functions are executed on the receiving thread, offloaded ones on the worker threads
+// and adaptive ones move to the receiving thread while measured to be fast
+void TestExecutionPolicy()
+{
+  using Signature = std::size_t(void);
+
+  // identifies the thread executing the call
+  const auto implementation = [] { return std::hash<std::thread::id>()(std::this_thread::get_id()); };
+
+  CppRpc::LocalDummyTransport transport;
+
+  const CppRpc::DispatcherHandle<CppRpc::InterfaceMode::Server> serverDispatcher = CppRpc::MakeDispatcherHandle(transport.GetServerTransport(), 2);
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Server> server(serverDispatcher, "TestExecutionPolicy");
+  CppRpc::Interface<CppRpc::InterfaceMode::Server>::Function<Signature> serverInline = {server, "Inline", implementation, CppRpc::ExecutionPolicy::Inline};
+  CppRpc::Interface<CppRpc::InterfaceMode::Server>::Function<Signature> serverOffload = {server, "Offload", implementation, CppRpc::ExecutionPolicy::Offload};
+  CppRpc::Interface<CppRpc::InterfaceMode::Server>::Function<Signature> serverAdaptive = {server, "Adaptive", implementation, CppRpc::ExecutionPolicy::Adaptive};
+
+  const CppRpc::DispatcherHandle<CppRpc::InterfaceMode::Client> clientDispatcher = CppRpc::MakeDispatcherHandle(transport.GetClientTransport());
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Client> client(clientDispatcher, "TestExecutionPolicy");
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<Signature> clientInline = {client, "Inline", nullptr};
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<Signature> clientOffload = {client, "Offload", nullptr};
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<Signature> clientAdaptive = {client, "Adaptive", nullptr};
+
+  const std::size_t receivingThread = clientInline();
+
+  for (int n = 0; n < 10; ++n)
+  {
+    assert(clientInline() == receivingThread);
+    assert(clientOffload() != receivingThread);
+
+    clientAdaptive();
+  }
+
+  assert(clientAdaptive() == receivingThread);
+
+  // decision stays while the function stays fast
+  for (int n = 0; n < 50; ++n)
+  {
+    assert(clientAdaptive() == receivingThread);
+  }
+
+  // an adaptive function getting slow moves to the worker threads, and back once fast again
+  std::atomic<bool> slow(false);
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Server>::Function<Signature> serverChanging = {server, "Changing",
+                                                                                          [&slow, &implementation]
+                                                                                          {
+                                                                                            if (slow)
+                                                                                            {
+                                                                                              std::this_thread::sleep_for(std::chrono::microseconds(100));
+                                                                                            }
+
+                                                                                            return implementation();
+                                                                                          },
+                                                                                          CppRpc::ExecutionPolicy::Adaptive};
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<Signature> clientChanging = {client, "Changing", nullptr};
+
+  const auto waitForThread = [&clientChanging, receivingThread] (bool onReceivingThread)
+    {
+      for (int n = 0; n < 100000; ++n)
+      {
+        if ((clientChanging() == receivingThread) == onReceivingThread)
+        {
+          return true;
+        }
+      }
+
+      return false;
+    };
+
+  assert(waitForThread(true));
+
+  slow = true;
+
+  assert(waitForThread(false));
+
+  slow = false;
+
+  assert(waitForThread(true));
+}
+
+
+// batches are not nested, a batch entry being a batch is reported as malformed to its caller (the other entries are executed)
+void TestNestedBatch()
+{
+  using Marshaller = CppRpc::DefaultMarshaller<CppRpc::Dispatcher>;
+
+  CppRpc::LocalDummyTransport transport;
+
+  const CppRpc::DispatcherHandle<CppRpc::InterfaceMode::Server> serverDispatcher = CppRpc::MakeDispatcherHandle(transport.GetServerTransport(), 2);
 
   TestServer server(serverDispatcher);
 
-  TestClient client(transport.GetClientTransport());
+  const CppRpc::Buffer resolveResult = serverDispatcher->DoFunctionCall(Marshaller::SerializeResolveFunction(server, "TestFunc3"));
+  const CppRpc::Buffer callHeader = Marshaller::SerializeFunctionCallHeader(Marshaller::DeserializeResolveFunctionResult(Marshaller::DeserializeMessageHeader(resolveResult).m_Payload));
 
-  int i;
-  bool b;
+  CppRpc::Buffer call = Marshaller::SerializeFunctionCall<boost::mpl::vector<int>>(CppRpc::Buffer(), callHeader, 0, 4711);
+  Marshaller::SetCorrelationId(call, 1);
 
-  client.TestFunc1();
+  CppRpc::Buffer nested;
+  Marshaller::SerializeBatchHeader(nested, CppRpc::Detail::MessageType::Batch);
+  Marshaller::AppendBatchMessage(nested, call);
+  Marshaller::SetCorrelationId(nested, 2);
 
-  i = client.TestFunc2();
+  CppRpc::Buffer batch;
+  Marshaller::SerializeBatchHeader(batch, CppRpc::Detail::MessageType::Batch);
+  Marshaller::AppendBatchMessage(batch, call);
+  Marshaller::AppendBatchMessage(batch, nested);
 
-  i = client.TestFunc3(4711);
+  const auto checkResult = [] (CppRpc::BufferView resultData)
+    {
+      const CppRpc::Detail::MessageHeader header = Marshaller::DeserializeMessageHeader(resultData);
+      assert(header.m_Type == CppRpc::Detail::MessageType::BatchResult);
 
-  b = client.TestFunc4("Hallo");
-  
-  b = true;
-  b = client.TestFunc5("foo", b);
+      const std::vector<CppRpc::BufferView> results = Marshaller::DeserializeBatch(header.m_Payload);
+      assert(results.size() == 2);
 
-  TestImplementation::TestFunc6ParamType fkt6Param;
+      for (CppRpc::BufferView result : results)
+      {
+        const CppRpc::Detail::MessageHeader resultHeader = Marshaller::DeserializeMessageHeader(result);
+        assert(resultHeader.m_Type == CppRpc::Detail::MessageType::Result);
 
-  fkt6Param[4711] = {"Hallo", "World!"};
-  fkt6Param[815] = {"this", "is", "almost", "magic"};
+        bool thrown = false;
 
-  TestImplementation::TestFunc6ReturnType fkt6Ret = client.TestFunc6(fkt6Param);
+        try
+        {
+          const int i = Marshaller::DeserializeResult<int>(resultHeader.m_Payload);
+          assert((resultHeader.m_CorrelationId == 1) && (i == 4711));
+          (void) i;
+        }
 
-  //client.TestFunc();  // must not compile (TestFunc not a member of TestClient)
-  //b = client.TestFunc5(false);  // must not compile (invalid number of arguments, static assert)
-  //b = client.TestFunc5(true, "foo");  // must not compile (unable to convert argument, static assert)  
+        catch (const CppRpc::UnknowRemoteException&)
+        {
+          thrown = true;
+        }
 
+        assert(thrown == (resultHeader.m_CorrelationId == 2));
+      }
+    };
 
+  // executed one after the other
+  checkResult(serverDispatcher->DoFunctionCall(batch));
 
-  // test ecxeption handling
+  // executed in parallel on the worker threads
+  transport.GetClientTransport().Send(CppRpc::Buffer(batch));
 
-  TestServerThrows throwingServer(serverDispatcher);
+  CppRpc::Buffer resultData;
 
-  TestClientThrows throwingClient(client.GetDispatcher());
+  while (!transport.GetClientTransport().Receive(resultData))
+  {}
+
+  checkResult(resultData);
+}
+
+
+constexpr char StaticFunc3Name[] = "TestFunc3";
+constexpr char StaticFunc5Name[] = "TestFunc5";
+constexpr char StaticFunc7Name[] = "TestFunc7";
+
+// functions declared at compile time are called by ordinary clients, next to runtime registered ones
+void TestStaticInterface()
+{
+  using StaticServer = CppRpc::StaticInterface<CppRpc::StaticFunction<int(int), &TestImplementation::TestFunc3, StaticFunc3Name>,
+                                               CppRpc::StaticFunction<bool(const std::string&, bool), &TestImplementation::TestFunc5, StaticFunc5Name, CppRpc::ExecutionPolicy::Inline>,
+                                               CppRpc::StaticOneWayFunction<void(int), &TestImplementation::TestFunc7, StaticFunc7Name>>;
+
+  static_assert(StaticServer::FunctionCount == 3, "");
+
+  CppRpc::LocalDummyTransport transport;
+
+  const CppRpc::DispatcherHandle<CppRpc::InterfaceMode::Server> serverDispatcher = CppRpc::MakeDispatcherHandle(transport.GetServerTransport(), 2);
+
+  StaticServer server(serverDispatcher, "TestStaticInterface");
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Server> dynamicServer(serverDispatcher, "TestDynamicInterface");
+  CppRpc::Interface<CppRpc::InterfaceMode::Server>::Function<int(int)> dynamicFunc3 = {dynamicServer, "TestFunc3", &TestImplementation::TestFunc3};
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Client> client(transport.GetClientTransport(), "TestStaticInterface");
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<int(int)> clientFunc3 = {client, "TestFunc3", nullptr};
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<bool(const std::string&, bool)> clientFunc5 = {client, "TestFunc5", nullptr};
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<void(int)> clientFunc7 = {client, "TestFunc7", nullptr, CppRpc::OneWay};
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Client> dynamicClient(client.GetDispatcher(), "TestDynamicInterface");
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<int(int)> dynamicClientFunc3 = {dynamicClient, "TestFunc3", nullptr};
+
+  assert(clientFunc3(4711) == 4711);
+  assert(clientFunc5("Hallo", true));
+  assert(!clientFunc5("Hallo", false));
+  assert(dynamicClientFunc3(42) == 42);
+
+  clientFunc7(9876);
+
+  // one-way calls are not ordered with calls executed on the receiving thread
+  while (TestImplementation::TestFunc7Value != 9876)
+  {
+    std::this_thread::yield();
+  }
+
+  // the same functions can not be registered twice, nothing of the second instance is left behind
+  bool thrown = false;
+
+  try
+  {
+    StaticServer duplicate(serverDispatcher, "TestStaticInterface");
+  }
+
+  catch (const CppRpc::FunctionAlreadyRegistred&)
+  {
+    thrown = true;
+  }
+
+  assert(thrown);
+  assert(clientFunc3(4711) == 4711);
+}
+
+
+#if defined(__linux__)
+// calls in flight when the server goes away fail instead of waiting forever, later calls fail right away
+// results too big for the shared memory ring are reported to the caller, the server keeps serving
+void TestOversizedResult(std::size_t workerThreadCount)
+{
+  const std::string name = (boost::format("/cpprpc-test-oversized-%1%") % getpid()).str();
+
+  CppRpc::SharedMemoryServerTransport serverTransport(name, 64 * 1024);
+  CppRpc::SharedMemoryClientTransport clientTransport(name);
+
+  const CppRpc::DispatcherHandle<CppRpc::InterfaceMode::Server> serverDispatcher = CppRpc::MakeDispatcherHandle(serverTransport, workerThreadCount);
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Server> server(serverDispatcher, "TestOversizedResult");
+  CppRpc::Interface<CppRpc::InterfaceMode::Server>::Function<std::string(std::size_t)> serverGetString = {server, "GetString", [] (std::size_t size) { return std::string(size, 'x'); }};
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Client> client(clientTransport, "TestOversizedResult");
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<std::string(std::size_t)> getString = {client, "GetString", nullptr};
+
+  assert(getString(1024).size() == 1024);
+
+  bool thrown = false;
+
+  try
+  {
+    getString(100 * 1024);
+  }
+
+  catch (const CppRpc::UnknowRemoteException&)
+  {
+    thrown = true;
+  }
+
+  assert(thrown);
+  assert(getString(16 * 1024).size() == 16 * 1024);
+
+  // results of a batch fitting the ring one by one only are sent separately
+  {
+    std::vector<CppRpc::AsyncResult<std::string>> results;
+
+    {
+      CppRpc::Interface<CppRpc::InterfaceMode::Client>::Batch batch(client.GetDispatcher());
+
+      results.push_back(getString.AsyncCall(20 * 1024));
+      results.push_back(getString.AsyncCall(20 * 1024));
+    }
+
+    for (auto& result : results)
+    {
+      assert(result.Get().size() == 20 * 1024);
+    }
+  }
+
+  assert(serverDispatcher->GetUnsentResultCount() == 0);
+}
+
+// a Unix domain socket peer sending more files than file frames is disconnected, the files are closed
+void TestExcessFiles(CppRpc::IoEngineType ioEngine)
+{
+  const std::string path = (boost::format("/tmp/cpprpc-test-files-%1%.sock") % getpid()).str();
+
+  CppRpc::UnixServerTransport serverTransport(path, 1024, std::chrono::milliseconds(10), ioEngine);
+
+  const int peer = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  assert(peer >= 0);
+
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  int result = connect(peer, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  assert(result == 0);
+
+  // empty ordinary frame, only a file frame may come with a file (and only one)
+  const int files[2] = {open("/dev/null", O_RDONLY | O_CLOEXEC), open("/dev/null", O_RDONLY | O_CLOEXEC)};
+
+  union
+  {
+    cmsghdr m_Header;  // alignment
+    char    m_Data[CMSG_SPACE(sizeof(files))];
+  } control;
+
+  std::memset(&control, 0, sizeof(control));
+
+  char frame[4] = {};
+  iovec part = {frame, sizeof(frame)};
+
+  msghdr message = {};
+  message.msg_iov = &part;
+  message.msg_iovlen = 1;
+  message.msg_control = control.m_Data;
+  message.msg_controllen = sizeof(control.m_Data);
+
+  cmsghdr* fileHeader = CMSG_FIRSTHDR(&message);
+  fileHeader->cmsg_level = SOL_SOCKET;
+  fileHeader->cmsg_type = SCM_RIGHTS;
+  fileHeader->cmsg_len = CMSG_LEN(sizeof(files));
+  std::memcpy(CMSG_DATA(fileHeader), files, sizeof(files));
+
+  result = static_cast<int>(sendmsg(peer, &message, MSG_NOSIGNAL));
+  assert(result == sizeof(frame));
+
+  close(files[0]);
+  close(files[1]);
+
+  // the server shuts the connection down
+  CppRpc::Buffer data;
+  bool closed = false;
+
+  for (int n = 0; (n < 1000) && !closed; ++n)
+  {
+    serverTransport.Receive(data);
+
+    char byte;
+
+    closed = (recv(peer, &byte, 1, MSG_DONTWAIT) == 0);
+  }
+
+  assert(closed);
+
+  close(peer);
+}
+
+void TestConnectionLost(CppRpc::IoEngineType ioEngine)
+{
+  std::unique_ptr<CppRpc::TcpServerTransport> tcpServerTransport(new CppRpc::TcpServerTransport(0, "127.0.0.1", CppRpc::TcpDefaultReceiveTimeout, ioEngine));
+
+  CppRpc::TcpClientTransport tcpClientTransport("127.0.0.1", tcpServerTransport->GetPort(), CppRpc::TcpDefaultReceiveTimeout, ioEngine);
+
+  TestClient tcpClient(tcpClientTransport);
+
+  {
+    TestServer::DispatcherHandle serverDispatcher = CppRpc::V1::MakeDispatcherHandle(*tcpServerTransport);
+
+    TestServer tcpServer(serverDispatcher);
+
+    // resolves the function id
+    const int i = tcpClient.TestFunc3(4711);
+    assert(i == 4711);
+    (void) i;
+
+    serverDispatcher->RemoveTransport(*tcpServerTransport);
+  }
+
+  CppRpc::AsyncResult<int> result = tcpClient.TestFunc3.AsyncCall(815);
+
+  // call arrived, never answered
+  CppRpc::Buffer callData;
+
+  while (!tcpServerTransport->Receive(callData))
+  {}
+
+  tcpServerTransport.reset();
+
+  bool thrown = false;
+
+  try
+  {
+    result.Get();
+  }
+
+  catch (const CppRpc::UnknowRemoteException&)
+  {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  thrown = false;
+
+  try
+  {
+    tcpClient.TestFunc3(4711);
+  }
+
+  catch (const CppRpc::TransportError&)
+  {
+    thrown = true;
+  }
+
+  assert(thrown);
+}
+#endif
+
+
+#ifdef CPPRPC_HAS_PMR
+// parameters taking a std::pmr allocator are de-serialized into the argument arena of the call
+void TestArgumentArena(const CppRpc::DispatcherHandle<CppRpc::InterfaceMode::Server>& serverDispatcher, const CppRpc::DispatcherHandle<CppRpc::InterfaceMode::Client>& clientDispatcher)
+{
+  using ParamType = std::pmr::map<std::pmr::string, std::pmr::list<std::pmr::string>>;
+  using Signature = std::size_t(const ParamType&, const std::pmr::vector<int>&);
+
+  const auto implementation = [] (const ParamType& strings, const std::pmr::vector<int>& numbers)
+    {
+      std::pmr::memory_resource* arena = numbers.get_allocator().resource();
+
+      assert(arena != std::pmr::get_default_resource());
+
+      std::size_t count = numbers.size();
+
+      for (const auto& list : strings)
+      {
+        assert((list.first.get_allocator().resource() == arena) && (list.second.get_allocator().resource() == arena));
+
+        count += list.second.size();
+      }
+
+      return count;
+    };
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Server> server(serverDispatcher, "TestArgumentArena");
+  CppRpc::Interface<CppRpc::InterfaceMode::Server>::Function<Signature> serverFunction = {server, "Count", implementation};
+
+  CppRpc::Interface<CppRpc::InterfaceMode::Client> client(clientDispatcher, "TestArgumentArena");
+  CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<Signature> clientFunction = {client, "Count", implementation};
+
+  ParamType strings;
+
+  strings["first key, too long to be stored inline"] = {"Hallo", "World!"};
+  strings["second"] = {std::pmr::string(1000, 'x')};
+
+  const std::size_t count = clientFunction(strings, std::pmr::vector<int>(10, 42));
+  assert(count == 13);
+}
+#endif
+
+
+int main()
+{
+  TestSerializer<CppRpc::BinarySerializer>();
+  TestSerializer<CppRpc::TextSerializer>();
+
+  TestBulkSerialization();
+
+  TestBuffer();
+
+  CppRpc::V1::LocalDummyTransport transport;
+
+  TestServer::DispatcherHandle serverDispatcher = CppRpc::V1::MakeDispatcherHandle(transport.GetServerTransport());
+
+  TestServer server(serverDispatcher);
+
+  TestClient client(transport.GetClientTransport());
+
+  int i;
+  bool b;
+
+  client.TestFunc1();
+
+  i = client.TestFunc2();
+  assert(i == 1);
+
+  i = client.TestFunc3(4711);
+  assert(i == 4711);
+
+  b = client.TestFunc4("Hallo");
+  assert(b);
+  
+  b = true;
+  b = client.TestFunc5("foo", b);
+  assert(b);
+
+  TestImplementation::TestFunc6ParamType fkt6Param;
+
+  fkt6Param[4711] = {"Hallo", "World!"};
+  fkt6Param[815] = {"this", "is", "almost", "magic"};
+
+  TestImplementation::TestFunc6ReturnType fkt6Ret = client.TestFunc6(fkt6Param);
+  assert(fkt6Ret == TestImplementation::TestFunc6(fkt6Param));
+
+#ifdef CPPRPC_HAS_PMR
+  TestArgumentArena(serverDispatcher, client.GetDispatcher());
+#endif
+
+  //client.TestFunc();  // must not compile (TestFunc not a member of TestClient)
+  //b = client.TestFunc5(false);  // must not compile (invalid number of arguments, static assert)
+  //b = client.TestFunc5(true, "foo");  // must not compile (unable to convert argument, static assert)  
+
+
+  // test calling a function unknown to the server (function id can not be resolved)
+  {
+    CppRpc::Interface<CppRpc::InterfaceMode::Client> unknownInterface(client.GetDispatcher(), "UnknownInterface");
+    CppRpc::Interface<CppRpc::InterfaceMode::Client>::Function<void(void)> unknownFunction = {unknownInterface, "UnknownFunction", nullptr};
+
+    bool thrown = false;
+
+    try
+    {
+      unknownFunction();
+    }
+
+    catch (const CppRpc::UnknownFunction&)
+    {
+      thrown = true;
+    }
+
+    assert(thrown);
+  }
+
+
+  // test concurrent calls through the same client dispatcher, every caller must get the result of its own call
+  {
+    std::vector<std::thread> callers;
+
+    for (int caller = 0; caller < 4; ++caller)
+    {
+      callers.emplace_back([&client, caller]
+        {
+          for (int n = 0; n < 100; ++n)
+          {
+            const int value = caller * 1000 + n;
+
+            const int result = client.TestFunc3(value);
+            assert(result == value);
+            (void) result;
+          }
+        });
+    }
+
+    for (auto& caller : callers)
+    {
+      caller.join();
+    }
+  }
+
+
+  // test asynchronous calls, all calls are in flight before the first result is used
+  {
+    std::vector<CppRpc::AsyncResult<int>> results;
+
+    for (int n = 0; n < 100; ++n)
+    {
+      results.push_back(client.TestFunc3.AsyncCall(n));
+    }
+
+    for (int n = 0; n < 100; ++n)
+    {
+      i = results[n].Get();
+      assert(i == n);
+    }
+
+    CppRpc::AsyncResult<void> result = client.TestFunc1.AsyncCall();
+    result.Wait();
+    assert(result.IsReady());
+    result.Get();
+
+    CppRpc::AsyncResult<bool> result5 = client.TestFunc5.AsyncCall("foo", true);
+    b = result5.Get();
+    assert(b);
+
+    //client.TestFunc5.AsyncCall(false);  // must not compile (invalid number of arguments, static assert)
+    //client.TestFunc5.AsyncCall(true, "foo");  // must not compile (unable to convert argument, static assert)
+
+#ifdef CPPRPC_HAS_COROUTINES
+    TestAwait(client).m_Done.get();
+#endif
+  }
+
+
+  // test one-way function, calls are executed in order, the next (synchronous) call returns after it was executed
+  client.TestFunc7(42);
+
+  i = client.TestFunc2();
+  assert(TestImplementation::TestFunc7Value == 42);
+
+  {
+    TestClient::Batch batch(client.GetDispatcher());
+
+    client.TestFunc7(4711);
+  }
+
+  i = client.TestFunc2();
+  assert(TestImplementation::TestFunc7Value == 4711);
+
+
+  // test call batching, results are only available after the batch was sent
+  {
+    std::vector<CppRpc::AsyncResult<int>> results;
+
+    {
+      TestClient::Batch batch(client.GetDispatcher());
+
+      for (int n = 0; n < 10; ++n)
+      {
+        results.push_back(client.TestFunc3.AsyncCall(n));
+      }
+
+      assert(!results.front().IsReady());
+
+      // synchronous call flushes the batch
+      b = client.TestFunc4("Hallo");
+      assert(b);
+
+      for (int n = 10; n < 20; ++n)
+      {
+        results.push_back(client.TestFunc3.AsyncCall(n));
+      }
+    }
+
+    for (int n = 0; n < 20; ++n)
+    {
+      i = results[n].Get();
+      assert(i == n);
+    }
+  }
+
+
+  // test local transport directly, concurrent senders and timeouts
+  {
+    CppRpc::V1::LocalDummyTransport localTransport(std::chrono::milliseconds(10));
+
+    TestTransport(localTransport.GetServerTransport(), localTransport.GetClientTransport(), 1024);
+
+    CppRpc::Buffer data;
+
+    b = localTransport.GetServerTransport().Receive(data);
+    assert(!b);
+
+    std::vector<std::thread> senders;
+
+    for (int n = 0; n < 4; ++n)
+    {
+      senders.emplace_back([&localTransport, n]
+        {
+          for (int m = 0; m < 1000; ++m)
+          {
+            localTransport.GetClientTransport().Send(CppRpc::Buffer(1, static_cast<CppRpc::Byte>(n)));
+          }
+        });
+    }
+
+    int received[4] = {};
+
+    for (int n = 0; n < 4000; ++n)
+    {
+      while (!localTransport.GetServerTransport().Receive(data))
+      {}
+
+      assert(data.size() == 1);
+      ++received[data[0]];
+    }
+
+    for (auto& sender : senders)
+    {
+      sender.join();
+    }
+
+    for (int n = 0; n < 4; ++n)
+    {
+      assert(received[n] == 1000);
+    }
+
+    b = localTransport.GetServerTransport().Receive(data);
+    assert(!b);
+  }
+
+
+  // test server executing calls on worker threads
+  TestExecutionPolicy();
+
+  TestStaticInterface();
+
+  TestNestedBatch();
+
+  {
+    CppRpc::V1::LocalDummyTransport workerTransport;
+
+    TestServer workerServer(CppRpc::V1::MakeDispatcherHandle(workerTransport.GetServerTransport(), 4));
+
+    TestClient workerClient(workerTransport.GetClientTransport());
+
+    for (int n = 0; n < 100; ++n)
+    {
+      i = workerClient.TestFunc3(n);
+      assert(i == n);
+    }
+
+    fkt6Ret = workerClient.TestFunc6(fkt6Param);
+    assert(fkt6Ret == TestImplementation::TestFunc6(fkt6Param));
+
+    // calls of a batch are executed in parallel
+    std::vector<CppRpc::AsyncResult<int>> results;
+
+    {
+      TestClient::Batch batch(workerClient.GetDispatcher());
+
+      for (int n = 0; n < 100; ++n)
+      {
+        results.push_back(workerClient.TestFunc3.AsyncCall(n));
+      }
+    }
+
+    for (int n = 0; n < 100; ++n)
+    {
+      i = results[n].Get();
+      assert(i == n);
+    }
+  }
+
+
+#if defined(__linux__)
+  // test TCP transport over loopback, with both I/O engines (automatic picks io_uring if supported)
+  for (CppRpc::IoEngineType ioEngine : {CppRpc::IoEngineType::Epoll, CppRpc::IoEngineType::Automatic})
+  {
+    CppRpc::TcpServerTransport tcpServerTransport(0, "127.0.0.1", CppRpc::TcpDefaultReceiveTimeout, ioEngine);
+
+    {
+      CppRpc::TcpClientTransport tcpClientTransport("127.0.0.1", tcpServerTransport.GetPort(), CppRpc::TcpDefaultReceiveTimeout, ioEngine);
+
+      TestTransport(tcpServerTransport, tcpClientTransport, 1024 * 1024);
+    }
+
+    TestServer tcpServer(CppRpc::V1::MakeDispatcherHandle(tcpServerTransport));
+
+    {
+      CppRpc::TcpClientTransport tcpClientTransport("127.0.0.1", tcpServerTransport.GetPort(), CppRpc::TcpDefaultReceiveTimeout, ioEngine);
+
+      TestClient tcpClient(tcpClientTransport);
+
+      i = tcpClient.TestFunc3(4711);
+      assert(i == 4711);
+
+      fkt6Ret = tcpClient.TestFunc6(fkt6Param);
+      assert(fkt6Ret == TestImplementation::TestFunc6(fkt6Param));
+
+      // big call, spans many reads
+      b = tcpClient.TestFunc4(std::string(1024 * 1024, 'x'));
+      assert(b);
+
+      std::vector<CppRpc::AsyncResult<int>> results;
+
+      for (int n = 0; n < 100; ++n)
+      {
+        results.push_back(tcpClient.TestFunc3.AsyncCall(n));
+      }
+
+      {
+        TestClient::Batch batch(tcpClient.GetDispatcher());
+
+        for (int n = 100; n < 200; ++n)
+        {
+          results.push_back(tcpClient.TestFunc3.AsyncCall(n));
+        }
+      }
+
+      for (int n = 0; n < 200; ++n)
+      {
+        i = results[n].Get();
+        assert(i == n);
+      }
+    }
+
+    // server accepts the next client after the previous one disconnected
+    {
+      CppRpc::TcpClientTransport nextClientTransport("127.0.0.1", tcpServerTransport.GetPort(), CppRpc::TcpDefaultReceiveTimeout, ioEngine);
+
+      TestClient nextClient(nextClientTransport);
+
+      i = nextClient.TestFunc3(815);
+      assert(i == 815);
+    }
+
+    TestConnectionLost(ioEngine);
+
+    // peer not receiving, sends fail once the socket buffers are full instead of blocking forever
+    {
+      CppRpc::TcpClientTransport stalledClientTransport("127.0.0.1", tcpServerTransport.GetPort(), CppRpc::TcpDefaultReceiveTimeout, ioEngine, std::chrono::milliseconds(50));
+
+      tcpServer.GetDispatcher()->RemoveTransport(tcpServerTransport);
+
+      const CppRpc::Buffer data(1024 * 1024, 42);
+
+      bool thrown = false;
+
+      try
+      {
+        for (int n = 0; n < 1000; ++n)
+        {
+          stalledClientTransport.Send(data);
+        }
+      }
+
+      catch (const CppRpc::TransportError&)
+      {
+        thrown = true;
+      }
+
+      assert(thrown);
+    }
+  }
+
+
+  // test shared memory transport, small rings wrap around many times
+  {
+    const std::string name = (boost::format("/cpprpc-test-%1%") % getpid()).str();
+
+    CppRpc::SharedMemoryServerTransport shmServerTransport(name, 64 * 1024);
+    CppRpc::SharedMemoryClientTransport shmClientTransport(name);
+
+    TestTransport(shmServerTransport, shmClientTransport, 16 * 1024);
+
+    TestServer shmServer(CppRpc::V1::MakeDispatcherHandle(shmServerTransport));
+
+    TestClient shmClient(shmClientTransport);
+
+    for (int n = 0; n < 1000; ++n)
+    {
+      i = shmClient.TestFunc3(n);
+      assert(i == n);
+    }
+
+    fkt6Ret = shmClient.TestFunc6(fkt6Param);
+    assert(fkt6Ret == TestImplementation::TestFunc6(fkt6Param));
+
+    // big message, wraps around the ring
+    b = shmClient.TestFunc4(std::string(16 * 1024, 'x'));
+    assert(b);
+
+    std::vector<CppRpc::AsyncResult<int>> results;
+
+    for (int n = 0; n < 1000; ++n)
+    {
+      results.push_back(shmClient.TestFunc3.AsyncCall(n));
+    }
+
+    for (int n = 0; n < 1000; ++n)
+    {
+      i = results[n].Get();
+      assert(i == n);
+    }
+
+    // too big for the ring
+    bool thrown = false;
+
+    try
+    {
+      shmClient.TestFunc4(std::string(64 * 1024, 'x'));
+    }
+
+    catch (const CppRpc::TransportError&)
+    {
+      thrown = true;
+    }
+
+    assert(thrown);
+
+    // sending into a full ring gives up after the send timeout, the peer does not receive
+    CppRpc::SharedMemoryServerTransport fullServerTransport(name + "-full", 64 * 1024, CppRpc::SharedMemoryDefaultReceiveTimeout, std::chrono::milliseconds(50));
+    CppRpc::SharedMemoryClientTransport fullClientTransport(name + "-full");
+
+    const CppRpc::Buffer data(1024);
+
+    thrown = false;
+
+    try
+    {
+      for (;;)
+      {
+        fullServerTransport.Send(data);
+      }
+    }
+
+    catch (const CppRpc::TransportError&)
+    {
+      thrown = true;
+    }
+
+    assert(thrown);
+  }
+
+  TestOversizedResult(0);
+  TestOversizedResult(2);
+
+  for (CppRpc::IoEngineType ioEngine : {CppRpc::IoEngineType::Epoll, CppRpc::IoEngineType::Automatic})
+  {
+    TestExcessFiles(ioEngine);
+  }
+
+
+  // test Unix domain socket transport, big frames are handed over as memfd (threshold 0 sends everything through the socket)
+  for (std::size_t fileThreshold : {std::size_t(1024), std::size_t(0)})
+  {
+    for (CppRpc::IoEngineType ioEngine : {CppRpc::IoEngineType::Epoll, CppRpc::IoEngineType::Automatic})
+    {
+      const std::string path = (boost::format("/tmp/cpprpc-test-%1%.sock") % getpid()).str();
+
+      CppRpc::UnixServerTransport unixServerTransport(path, fileThreshold, CppRpc::UnixDefaultReceiveTimeout, ioEngine);
+      CppRpc::UnixClientTransport unixClientTransport(path, fileThreshold, CppRpc::UnixDefaultReceiveTimeout, ioEngine);
+
+      TestTransport(unixServerTransport, unixClientTransport, 64 * 1024);
+
+      TestServer unixServer(CppRpc::V1::MakeDispatcherHandle(unixServerTransport));
+
+      TestClient unixClient(unixClientTransport);
+
+      i = unixClient.TestFunc3(4711);
+      assert(i == 4711);
+
+      fkt6Ret = unixClient.TestFunc6(fkt6Param);
+      assert(fkt6Ret == TestImplementation::TestFunc6(fkt6Param));
+
+      b = unixClient.TestFunc4(std::string(1024 * 1024, 'x'));
+      assert(b);
+
+      // small and big frames interleaved
+      std::vector<CppRpc::AsyncResult<bool>> results;
+
+      for (int n = 0; n < 100; ++n)
+      {
+        results.push_back(unixClient.TestFunc4.AsyncCall(std::string((n % 2 == 0) ? 10 : 64 * 1024, 'x')));
+      }
+
+      for (int n = 0; n < 100; ++n)
+      {
+        b = results[n].Get();
+        assert(b);
+      }
+    }
+  }
+
+
+  // one server dispatcher serving several transports, clients connected at the same time get their own results from the worker threads
+  {
+    const std::string path = (boost::format("/tmp/cpprpc-test-%1%.sock") % getpid()).str();
+
+    CppRpc::UnixServerTransport unixServerTransport(path);
+    CppRpc::V1::LocalDummyTransport localTransport;
+
+    TestServer::DispatcherHandle dispatcher = CppRpc::V1::MakeDispatcherHandle(unixServerTransport, 4);
+
+    dispatcher->AddTransport(localTransport.GetServerTransport());
+
+    TestServer server(dispatcher);
+
+    std::vector<std::unique_ptr<CppRpc::UnixClientTransport>> clientTransports;
+    std::vector<std::unique_ptr<TestClient>> clients;
+
+    for (int n = 0; n < 10; ++n)
+    {
+      clientTransports.emplace_back(new CppRpc::UnixClientTransport(path));
+      clients.emplace_back(new TestClient(*clientTransports.back()));
+    }
+
+    clients.emplace_back(new TestClient(localTransport.GetClientTransport()));
+
+    std::vector<CppRpc::AsyncResult<int>> results;
+
+    for (int n = 0; n < 1100; ++n)
+    {
+      results.push_back(clients[n % clients.size()]->TestFunc3.AsyncCall(n));
+    }
+
+    for (int n = 0; n < 1100; ++n)
+    {
+      i = results[n].Get();
+      assert(i == n);
+    }
+
+    assert(unixServerTransport.GetConnectionCount() == 10);
+
+    dispatcher->RemoveTransport(localTransport.GetServerTransport());
+
+    bool thrown = false;
+
+    try
+    {
+      dispatcher->RemoveTransport(localTransport.GetServerTransport());
+    }
+
+    catch (const CppRpc::UnknownTransport&)
+    {
+      thrown = true;
+    }
+
+    assert(thrown);
+
+    // disconnected clients are released by the server
+    clients.clear();
+    clientTransports.clear();
+
+    for (int n = 0; (n < 1000) && (unixServerTransport.GetConnectionCount() > 0); ++n)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    assert(unixServerTransport.GetConnectionCount() == 0);
+  }
+
+
+  // shard-per-core server, TCP clients are distributed between two shards listening on the same port, functions registered afterwards reach both
+  {
+    CppRpc::TcpServerTransport firstShard(0, "127.0.0.1", CppRpc::TcpDefaultReceiveTimeout, CppRpc::IoEngineType::Automatic, true);
+    CppRpc::TcpServerTransport secondShard(firstShard.GetPort(), "127.0.0.1", CppRpc::TcpDefaultReceiveTimeout, CppRpc::IoEngineType::Automatic, true);
+
+    // shards execute calls themselves, worker threads are rejected
+    bool thrown = false;
+
+    try
+    {
+      CppRpc::V1::MakeDispatcherHandle(firstShard, 2, CppRpc::ServerMode::ShardPerCore);
+    }
+
+    catch (const std::invalid_argument&)
+    {
+      thrown = true;
+    }
+
+    assert(thrown);
+
+    TestServer::DispatcherHandle dispatcher = CppRpc::V1::MakeDispatcherHandle(firstShard, 0, CppRpc::ServerMode::ShardPerCore);
+
+    dispatcher->AddTransport(secondShard);
+
+    TestServer server(dispatcher);
+
+    std::vector<std::unique_ptr<CppRpc::TcpClientTransport>> clientTransports;
+    std::vector<std::unique_ptr<TestClient>> clients;
+
+    for (int n = 0; n < 8; ++n)
+    {
+      clientTransports.emplace_back(new CppRpc::TcpClientTransport("127.0.0.1", firstShard.GetPort()));
+      clients.emplace_back(new TestClient(*clientTransports.back()));
+    }
+
+    for (int n = 0; n < 800; ++n)
+    {
+      i = clients[n % clients.size()]->TestFunc3(n);
+      assert(i == n);
+    }
+
+    fkt6Ret = clients.front()->TestFunc6(fkt6Param);
+    assert(fkt6Ret == TestImplementation::TestFunc6(fkt6Param));
+
+    assert(firstShard.GetConnectionCount() + secondShard.GetConnectionCount() == 8);
+  }
+#endif
+
+
+  // test ecxeption handling
+
+  TestServerThrows throwingServer(serverDispatcher);
+
+  TestClientThrows throwingClient(client.GetDispatcher());
+
+  // exceptions of asynchronous calls are thrown by AsyncResult::Get()
+  {
+    bool thrown = false;
+
+    try
+    {
+      throwingClient.TestFunc3.AsyncCall(4711).Get();
+    }
+
+    catch (const CppRpc::UnknowRemoteException&)
+    {
+      thrown = true;
+    }
+
+    assert(thrown);
+  }
+
+  // exceptions of one-way functions are counted and reported to the error handler on the server
+  std::vector<std::string> reportedErrors;
+  std::mutex               reportedErrorsMutex;
+
+  serverDispatcher->SetErrorHandler([&] (const std::string& description)
+                                    {
+                                      std::lock_guard<std::mutex> lock(reportedErrorsMutex);
+                                      reportedErrors.push_back(description);
+                                    });
+
+  throwingClient.TestFunc7(4711);
+
+  i = client.TestFunc2();
+  assert(serverDispatcher->GetOneWayExceptionCount() == 1);
+
+  {
+    std::lock_guard<std::mutex> lock(reportedErrorsMutex);
+    assert((reportedErrors.size() == 1) && (reportedErrors.front().find("One-way function call failed") != std::string::npos));
+  }
+
+  serverDispatcher->SetErrorHandler(nullptr);
 
   // TODO: add test code that chacks for exception thrown and the exception type
   //throwingClient.TestFunc1(); 
@@ -0,0 +1,146 @@
+#ifndef CPPRPC_TEXTSERIALIZER_H
+#define CPPRPC_TEXTSERIALIZER_H
+
+#pragma once
+
+#include <string>
+#include <streambuf>
+#include <istream>
+#include <ostream>
+
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/serialization/version.hpp>
+#include <boost/serialization/string.hpp>
+#pragma warning(push)
+#pragma warning(disable: 4100)  // boost/serialization/collections_load_imp.hpp(67): warning C4100: 'item_version': unreferenced formal parameter
+#include <boost/serialization/vector.hpp>
+#pragma warning(pop)
+#include <boost/serialization/variant.hpp>
+
+#include "cpprpc/Types.h"
+
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+    namespace Detail
+    {
+
+      // output stream buffer appending to a Buffer
+      class BufferStreamBuf : public std::streambuf
+      {
+        public:
+          explicit BufferStreamBuf(Buffer& buffer)
+          : std::streambuf(), m_Buffer(buffer)
+          {}
+
+        protected:
+          virtual int_type overflow(int_type ch) override
+          {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+              m_Buffer.push_back(static_cast<Byte>(ch));
+            }
+
+            return traits_type::not_eof(ch);
+          }
+
+          virtual std::streamsize xsputn(const char_type* data, std::streamsize count) override
+          {
+            m_Buffer.insert(m_Buffer.end(), reinterpret_cast<const Byte*>(data), reinterpret_cast<const Byte*>(data) + count);
+
+            return count;
+          }
+
+        private:
+          Buffer& m_Buffer;
+      };
+
+
+      // input stream buffer reading directly from a BufferView, no copy is made
+      class BufferViewStreamBuf : public std::streambuf
+      {
+        public:
+          explicit BufferViewStreamBuf(BufferView data)
+          : std::streambuf()
+          {
+            // get area is never written to, const_cast is safe here
+            char* begin = const_cast<char*>(reinterpret_cast<const char*>(data.data()));
+
+            setg(begin, begin, begin + data.size());
+          }
+      };
+
+
+      class TextOArchive
+      {
+        public:
+          // data gets appended to buffer, archive must be destroyed before buffer is used (boost archive flushes in destructor)
+          explicit TextOArchive(Buffer& buffer)
+          : m_StreamBuf(buffer), m_Stream(&m_StreamBuf), m_Archive(m_Stream)
+          {}
+
+          template <typename T>
+          TextOArchive& operator<<(const T& data)
+          {
+            m_Archive << data;
+            return *this;
+          }
+
+          template <typename T>
+          TextOArchive& operator&(const T& data)
+          {
+            return *this << data;
+          }
+
+        private:
+          BufferStreamBuf               m_StreamBuf;
+          std::ostream                  m_Stream;
+          boost::archive::text_oarchive m_Archive;
+      };
+
+
+      class TextIArchive
+      {
+        public:
+          // reads directly from data, no copy is made (data needs to outlive the archive)
+          explicit TextIArchive(BufferView data)
+          : m_StreamBuf(data), m_Stream(&m_StreamBuf), m_Archive(m_Stream)
+          {}
+
+          template <typename T>
+          TextIArchive& operator>>(T& data)
+          {
+            m_Archive >> data;
+            return *this;
+          }
+
+          template <typename T>
+          TextIArchive& operator&(T& data)
+          {
+            return *this >> data;
+          }
+
+        private:
+          BufferViewStreamBuf           m_StreamBuf;
+          std::istream                  m_Stream;
+          boost::archive::text_iarchive m_Archive;
+      };
+
+    }  // namespace Detail
+
+
+    // boost::serialization text archive, human readable, intended for debugging
+    // NOTE: user types need to include the boost/serialization headers for the used std containers
+    struct TextSerializer
+    {
+      using OArchive = Detail::TextOArchive;
+      using IArchive = Detail::TextIArchive;
+    };
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef CPPRPC_THREADPOOL_H
+#define CPPRPC_THREADPOOL_H
+
+#pragma once
+
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+#include <cassert>
+
+#include <boost/noncopyable.hpp>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+    namespace Detail
+    {
+
+      // pins the calling thread to the core-th of the cores the process (its main thread) may run on, wrapping around; the thread stays unpinned
+      // if this is not possible (or not supported on the platform)
+      inline void PinCurrentThread(std::size_t core)
+      {
+#if defined(__linux__)
+        cpu_set_t allowed;
+
+        if ((sched_getaffinity(getpid(), sizeof(allowed), &allowed) != 0) || (CPU_COUNT(&allowed) == 0))
+        {
+          // TODO: add trace / logging
+          return;
+        }
+
+        std::size_t index = core % static_cast<std::size_t>(CPU_COUNT(&allowed));
+
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+          if (CPU_ISSET(cpu, &allowed) && (index-- == 0))
+          {
+            cpu_set_t pinned;
+
+            CPU_ZERO(&pinned);
+            CPU_SET(cpu, &pinned);
+
+            pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+
+            return;
+          }
+        }
+#else
+        // TODO: pin on Windows (SetThreadAffinityMask())
+        static_cast<void>(core);
+#endif
+      }
+
+
+      // fixed size work-stealing thread pool
+      //
+      // every worker owns a task queue, tasks submitted from outside are distributed round-robin, tasks submitted from a worker
+      // go to its own queue; idle workers steal from the back of the other queues before going to sleep
+      //
+      // tasks are expected to handle their own errors, exceptions escaping a task are dropped (the worker keeps running)
+      class ThreadPool : boost::noncopyable
+      {
+        public:
+          using Task = std::function<void()>;
+
+          explicit ThreadPool(std::size_t threadCount)
+          : m_Queues(), m_Threads(), m_PendingTasks(0), m_Sleeping(0), m_Mutex(), m_CondVar(), m_NextQueue(0), m_Stop(false)
+          {
+            assert(threadCount > 0);
+
+            for (std::size_t i = 0; i < threadCount; ++i)
+            {
+              m_Queues.emplace_back(new Queue());
+            }
+
+            for (std::size_t i = 0; i < threadCount; ++i)
+            {
+              m_Threads.emplace_back(&ThreadPool::WorkerThread, this, i);
+            }
+          }
+
+          // executes all queued tasks before returning
+          ~ThreadPool()
+          {
+            {
+              std::lock_guard<std::mutex> lock(m_Mutex);
+
+              m_Stop = true;
+            }
+
+            m_CondVar.notify_all();
+
+            for (auto& thread : m_Threads)
+            {
+              thread.join();
+            }
+          }
+
+          void Submit(Task task)
+          {
+            const std::size_t queueIndex = (GetWorkerIndex() == NoWorker) ? (m_NextQueue++ % m_Queues.size()) : GetWorkerIndex();
+
+            {
+              Queue& queue = *m_Queues[queueIndex];
+
+              std::lock_guard<std::mutex> lock(queue.m_Mutex);
+
+              queue.m_Tasks.push_front(std::move(task));
+            }
+
+            m_PendingTasks.fetch_add(1);
+
+            // either a sleeping worker sees the pending task or we see the worker sleeping, see WorkerThread()
+            if (m_Sleeping.load() > 0)
+            {
+              std::lock_guard<std::mutex> lock(m_Mutex);
+
+              m_CondVar.notify_one();
+            }
+          }
+
+          std::size_t GetThreadCount() const
+          {
+            return m_Threads.size();
+          }
+
+        private:
+          struct Queue
+          {
+            std::mutex       m_Mutex;
+            std::deque<Task> m_Tasks;
+          };
+
+          std::vector<std::unique_ptr<Queue>> m_Queues;
+          std::vector<std::thread>            m_Threads;
+
+          std::atomic<std::size_t> m_PendingTasks;
+          std::atomic<std::size_t> m_Sleeping;  // workers waiting for tasks
+
+          std::mutex              m_Mutex;    // guards m_Stop, used for sleeping only
+          std::condition_variable m_CondVar;
+
+          std::atomic<std::size_t> m_NextQueue;
+          bool                     m_Stop;
+
+          static const std::size_t NoWorker = ~std::size_t(0);
+
+          // index of the worker queue of the calling thread, NoWorker if called from outside the pool
+          static std::size_t& GetWorkerIndex()
+          {
+            thread_local std::size_t workerIndex = NoWorker;
+
+            return workerIndex;
+          }
+
+          // own queue is used LIFO (cache locality), others are stolen from FIFO
+          bool TryPop(std::size_t queueIndex, Task& task)
+          {
+            for (std::size_t i = 0; i < m_Queues.size(); ++i)
+            {
+              Queue& queue = *m_Queues[(queueIndex + i) % m_Queues.size()];
+
+              std::lock_guard<std::mutex> lock(queue.m_Mutex);
+
+              if (!queue.m_Tasks.empty())
+              {
+                if (i == 0)
+                {
+                  task = std::move(queue.m_Tasks.front());
+                  queue.m_Tasks.pop_front();
+                }
+                else
+                {
+                  task = std::move(queue.m_Tasks.back());
+                  queue.m_Tasks.pop_back();
+                }
+
+                return true;
+              }
+            }
+
+            return false;
+          }
+
+          void WorkerThread(std::size_t queueIndex)
+          {
+            GetWorkerIndex() = queueIndex;
+
+            for (;;)
+            {
+              Task task;
+
+              if (TryPop(queueIndex, task))
+              {
+                m_PendingTasks.fetch_sub(1);
+
+                try
+                {
+                  task();
+                }
+
+                catch (...)
+                {
+                  // TODO: add trace / logging
+                }
+              }
+              else
+              {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+
+                // announce sleeping before checking for pending tasks, see Submit()
+                m_Sleeping.fetch_add(1);
+
+                // pending tasks might not be visible in a queue yet or got stolen meanwhile, loop again in both cases
+                m_CondVar.wait(lock, [this] { return m_Stop || (m_PendingTasks.load() > 0); });
+
+                m_Sleeping.fetch_sub(1);
+
+                if (m_Stop && (m_PendingTasks == 0))
+                {
+                  return;
+                }
+              }
+            }
+          }
+      };
+
+    }  // namespace Detail
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif
@@ -10,64 +10,234 @@ namespace CppRpc
   inline namespace V1
   {
 
-    LocalDummyTransport::LocalDummyTransport()
-    : m_Mutex(), m_ClientToServerQueueCondVar(), m_ServerToClientQueueCondVar(), m_ClientToServerQueue(), m_ServerToClientQueue(), 
-      m_Server(*this), m_Client(*this)
+    namespace Detail
     {
-    }
 
-    void LocalDummyTransport::ClientSend(const Buffer & data)
-    {
-      Lock lock(m_Mutex);
+      LocalChannel::LocalChannel()
+      : m_Queue(MaxPooledBuffers), m_Pool(MaxPooledBuffers), m_PoolSize(0), m_Waiting(0), m_Mutex(), m_CondVar(), m_Interrupted(false), m_Lent(nullptr)
+      {}
 
-      m_ClientToServerQueue.push_back(data);
+      LocalChannel::~LocalChannel()
+      {
+        Buffer* buffer = nullptr;
 
-      m_ClientToServerQueueCondVar.notify_one();
-    }
+        while (m_Queue.pop(buffer))
+        {
+          delete buffer;
+        }
 
-    void LocalDummyTransport::ServerSend(const Buffer & data)
-    {
-      Lock lock(m_Mutex);
+        while (m_Pool.pop(buffer))
+        {
+          delete buffer;
+        }
 
-      m_ServerToClientQueue.push_back(data);
+        delete m_Lent;
+      }
 
-      m_ServerToClientQueueCondVar.notify_one();
-    }
+      void LocalChannel::Send(const Buffer& data)
+      {
+        Buffer* buffer = GetPooled();
 
-    bool LocalDummyTransport::ClientReceive(Buffer& data)
-    {
-      Lock lock(m_Mutex);
+        buffer->assign(data.begin(), data.end());
 
-      if (m_ServerToClientQueueCondVar.wait_for(lock, std::chrono::milliseconds(Timeout), [this] { return !m_ServerToClientQueue.empty(); }))
+        Push(buffer);
+      }
+
+      void LocalChannel::Send(Buffer&& data)
       {
-        data = m_ServerToClientQueue.front();
+        Buffer* buffer = GetPooled();
 
-        m_ServerToClientQueue.pop_front();
+        buffer->swap(data);
+        data.clear();
 
-        return true;
+        Push(buffer);
       }
-      else
+
+      void LocalChannel::Send(const std::vector<BufferView>& segments)
       {
-        return false;
+        Buffer* buffer = GetPooled();
+
+        buffer->clear();
+
+        for (BufferView segment : segments)
+        {
+          buffer->insert(buffer->end(), segment.begin(), segment.end());
+        }
+
+        Push(buffer);
       }
-    }
 
-    bool LocalDummyTransport::ServerReceive(Buffer& data)
-    {
-      Lock lock(m_Mutex);
+      Buffer LocalChannel::Acquire()
+      {
+        Buffer* buffer = GetPooled();
 
-      if (m_ClientToServerQueueCondVar.wait_for(lock, std::chrono::milliseconds(Timeout), [this] { return !m_ClientToServerQueue.empty(); }))
+        // capacity is handed out, the (now empty) buffer stays in the pool
+        Buffer data;
+
+        data.swap(*buffer);
+        data.clear();
+
+        Recycle(buffer);
+
+        return data;
+      }
+
+      bool LocalChannel::Receive(Buffer& data, std::chrono::milliseconds timeout)
+      {
+        Buffer* buffer = Pop(timeout);
+
+        if (buffer == nullptr)
+        {
+          return false;
+        }
+
+        // hand out the queued buffer, recycle the one given by the caller
+        data.swap(*buffer);
+
+        Recycle(buffer);
+
+        return true;
+      }
+
+      bool LocalChannel::ReceiveLent(BufferView& data, std::chrono::milliseconds timeout)
       {
-        data = m_ClientToServerQueue.front();
+        assert(m_Lent == nullptr);
+
+        m_Lent = Pop(timeout);
 
-        m_ClientToServerQueue.pop_front();
+        if (m_Lent == nullptr)
+        {
+          return false;
+        }
+
+        data = *m_Lent;
 
         return true;
       }
-      else
+
+      void LocalChannel::Return()
       {
-        return false;
+        if (m_Lent != nullptr)
+        {
+          Recycle(m_Lent);
+
+          m_Lent = nullptr;
+        }
       }
+
+      Buffer* LocalChannel::GetPooled()
+      {
+        Buffer* buffer = nullptr;
+
+        if (m_Pool.pop(buffer))
+        {
+          m_PoolSize.fetch_sub(1, std::memory_order_relaxed);
+
+          return buffer;
+        }
+
+        return new Buffer();
+      }
+
+      void LocalChannel::Recycle(Buffer* buffer)
+      {
+        if ((m_PoolSize.fetch_add(1, std::memory_order_relaxed) < MaxPooledBuffers) && m_Pool.push(buffer))
+        {
+          return;
+        }
+
+        m_PoolSize.fetch_sub(1, std::memory_order_relaxed);
+
+        delete buffer;
+      }
+
+      void LocalChannel::Push(Buffer* buffer)
+      {
+        try
+        {
+          m_Queue.push(buffer);
+        }
+
+        catch (...)
+        {
+          delete buffer;
+          throw;
+        }
+
+        // either a waiting receiver sees the pushed buffer or we see the receiver waiting, see Pop()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_Waiting.load() > 0)
+        {
+          std::lock_guard<std::mutex> lock(m_Mutex);
+
+          m_CondVar.notify_one();
+        }
+      }
+
+      Buffer* LocalChannel::Pop(std::chrono::milliseconds timeout)
+      {
+        Buffer* buffer = nullptr;
+
+        if (m_Queue.pop(buffer))
+        {
+          return buffer;
+        }
+
+        const auto deadline = GetReceiveDeadline(timeout);
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+
+        // announce waiting before checking again, see Push()
+        m_Waiting.fetch_add(1);
+
+        while (!m_Queue.pop(buffer))
+        {
+          buffer = nullptr;
+
+          if (m_Interrupted)
+          {
+            m_Interrupted = false;
+
+            break;
+          }
+
+          if (deadline == std::chrono::steady_clock::time_point::max())
+          {
+            m_CondVar.wait(lock);
+          }
+          else if (m_CondVar.wait_until(lock, deadline) == std::cv_status::timeout)
+          {
+            if (!m_Queue.pop(buffer))
+            {
+              buffer = nullptr;
+            }
+
+            break;
+          }
+        }
+
+        m_Waiting.fetch_sub(1);
+
+        return buffer;
+      }
+
+      void LocalChannel::Interrupt()
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Interrupted = true;
+
+        m_CondVar.notify_all();
+      }
+
+    }  // namespace Detail
+
+
+    LocalDummyTransport::LocalDummyTransport(std::chrono::milliseconds receiveTimeout)
+    : m_ClientToServerChannel(), m_ServerToClientChannel(),
+      m_Server(m_ServerToClientChannel, m_ClientToServerChannel, receiveTimeout), m_Client(m_ClientToServerChannel, m_ServerToClientChannel, receiveTimeout)
+    {
     }
 
   }  // namespace V1
@@ -3,9 +3,17 @@
 
 #pragma once
 
-#include <list>
+#include <vector>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/noncopyable.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <boost/lockfree/stack.hpp>
 
 #include "cpprpc/Types.h"
 
@@ -13,71 +21,325 @@ namespace CppRpc
 {
   inline namespace V1
   {
+
+    // receive timeout of transports blocking until a message arrives or they are interrupted, see Transport::Interrupt()
+    const std::chrono::milliseconds InfiniteReceiveTimeout = std::chrono::milliseconds::max();
+
+    // identifies a client of a server transport serving several connections at once, see Transport::ReceiveFrom()
+    using ConnectionId = std::uint64_t;
+
+    // the only connection of transports serving a single client
+    const ConnectionId DefaultConnectionId = 0;
+
+    namespace Detail
+    {
+
+      // deadline of a receive starting now, time_point::max() for InfiniteReceiveTimeout
+      inline std::chrono::steady_clock::time_point GetReceiveDeadline(std::chrono::milliseconds timeout)
+      {
+        const auto now = std::chrono::steady_clock::now();
+
+        if (timeout >= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::time_point::max() - now))
+        {
+          return std::chrono::steady_clock::time_point::max();
+        }
+
+        return now + timeout;
+      }
+
+    }  // namespace Detail
+
             
-    template <InterfaceMode Mode>
+    template <InterfaceMode TransportMode>
     class Transport
     {
       public:
+        using Segments = std::vector<BufferView>;
+
         Transport()
+        : m_LentBuffer()
         {}
 
         virtual ~Transport() noexcept = default;
 
-        // TODO: replace or add I/O stream interface!
+        // NOTE: all Send() overloads, Acquire() and Commit() must be thread safe, server side worker threads send their responses concurrently
         virtual void Send(const Buffer& data) = 0;
+
+        // transports able to take over data instead of copying it override this, data is left empty (or with recycled capacity)
+        virtual void Send(Buffer&& data)
+        {
+          Send(static_cast<const Buffer&>(data));
+        }
+
+        // sends the segments as one message without concatenating them first (if the transport is able to gather)
+        virtual void Send(const Segments& segments)
+        {
+          Buffer data = Acquire();
+
+          for (BufferView segment : segments)
+          {
+            data.insert(data.end(), segment.begin(), segment.end());
+          }
+
+          Commit(std::move(data));
+        }
+
+        // empty buffer to serialize the next message into, pass it on to Commit(), transports hand out recycled buffers to avoid an allocation per message
+        virtual Buffer Acquire()
+        {
+          return Buffer();
+        }
+
+        // sends a buffer returned by Acquire(), data is left unchanged if sending fails (see Dispatcher::SendResult())
+        virtual void Commit(Buffer&& data)
+        {
+          Send(std::move(data));
+        }
+
+        // returns false after the timeout of the transport expired (if any) or if interrupted, throws TransportError if the connection is lost
         virtual bool Receive(Buffer& data) = 0;
 
-        static const auto Mode = Mode;
+        // like Receive(), but the message stays owned by the transport (and may refer to its receive memory in place) until Return() is called
+        // NOTE: receiving thread only, at most one message can be lent at a time
+        virtual bool ReceiveLent(BufferView& data)
+        {
+          if (!Receive(m_LentBuffer))
+          {
+            return false;
+          }
+
+          data = m_LentBuffer;
+
+          return true;
+        }
+
+        // hands the message lent by ReceiveLent() back to the transport
+        virtual void Return()
+        {}
+
+        // server transports serving several connections at once override these, connection identifies the client a message came from,
+        // results are sent back to it with SendTo() / CommitTo(); Send() and Commit() go to the connection of the message received last
+        virtual bool ReceiveFrom(Buffer& data, ConnectionId& connection)
+        {
+          connection = DefaultConnectionId;
+
+          return Receive(data);
+        }
+
+        virtual bool ReceiveLentFrom(BufferView& data, ConnectionId& connection)
+        {
+          connection = DefaultConnectionId;
+
+          return ReceiveLent(data);
+        }
+
+        // thread safe, messages for clients that are gone already are dropped
+        virtual void SendTo(ConnectionId /*connection*/, const Segments& segments)
+        {
+          Send(segments);
+        }
+
+        virtual void CommitTo(ConnectionId /*connection*/, Buffer&& data)
+        {
+          Commit(std::move(data));
+        }
+
+        // thread safe, makes a blocked Receive() / ReceiveLent() return false, or the next one if none is blocked;
+        // the dispatcher stops its receiving thread this way, transports not overriding it need a finite receive timeout
+        virtual void Interrupt()
+        {}
+
+        static const InterfaceMode Mode = TransportMode;
 
       protected:
+        Buffer m_LentBuffer;  // used by the default ReceiveLent() only
     };
 
 
+    namespace Detail
+    {
+
+      // buffers sent by transports copying them (e.g. to the kernel), recycled for Transport::Acquire()
+      class BufferPool : boost::noncopyable
+      {
+        public:
+          BufferPool()
+          : m_Mutex(), m_Buffers()
+          {}
+
+          // thread safe, returns an empty buffer keeping the capacity of a recycled one (if any)
+          Buffer Acquire()
+          {
+            Buffer buffer;
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if (!m_Buffers.empty())
+            {
+              buffer.swap(m_Buffers.back());
+
+              m_Buffers.pop_back();
+            }
+
+            return buffer;
+          }
+
+          // thread safe, keeps the capacity of buffer for the next Acquire()
+          void Recycle(Buffer&& buffer)
+          {
+            // inline buffers have nothing worth keeping
+            if ((buffer.capacity() <= Buffer::InlineCapacity) || (buffer.capacity() > MaxPooledCapacity))
+            {
+              return;
+            }
+
+            buffer.clear();
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if (m_Buffers.size() < MaxPooledBuffers)
+            {
+              m_Buffers.push_back(std::move(buffer));
+            }
+          }
+
+        private:
+          // bigger buffers are freed instead of being kept around
+          static const std::size_t MaxPooledBuffers = 16;
+          static const std::size_t MaxPooledCapacity = 1024 * 1024;
+
+          std::mutex          m_Mutex;
+          std::vector<Buffer> m_Buffers;
+      };
+
+
+      // in-process channel, lock-free multiple producer / multiple consumer queue of buffers
+      //
+      // buffers are moved through the queue, queued buffers are recycled to keep their capacity;
+      // receivers only block (and senders only notify) while the queue is empty
+      class LocalChannel : boost::noncopyable
+      {
+        public:
+          LocalChannel();
+          ~LocalChannel();
+
+          // thread safe, copies data into a recycled buffer
+          void Send(const Buffer& data);
+
+          // thread safe, takes the content of data, leaves a recycled buffer behind
+          void Send(Buffer&& data);
+
+          // thread safe, concatenates segments in a recycled buffer
+          void Send(const std::vector<BufferView>& segments);
+
+          // thread safe, returns an empty buffer keeping the capacity of a recycled one
+          Buffer Acquire();
+
+          // thread safe, returns false after the timeout expired or if interrupted
+          bool Receive(Buffer& data, std::chrono::milliseconds timeout);
+
+          // receiving thread only, the queued buffer itself is lent until Return()
+          bool ReceiveLent(BufferView& data, std::chrono::milliseconds timeout);
+          void Return();
+
+          // thread safe, see Transport::Interrupt()
+          void Interrupt();
+
+        private:
+          // recycled buffers kept per channel, further ones are freed
+          static const std::size_t MaxPooledBuffers = 64;
+
+          boost::lockfree::queue<Buffer*> m_Queue;
+          boost::lockfree::stack<Buffer*> m_Pool;
+          std::atomic<std::size_t>        m_PoolSize;
+
+          // receivers waiting for data, guarded by m_Mutex for sleeping only
+          std::atomic<std::size_t> m_Waiting;
+          std::mutex               m_Mutex;
+          std::condition_variable  m_CondVar;
+          bool                     m_Interrupted;  // guarded by m_Mutex
+
+          Buffer* m_Lent;  // see ReceiveLent()
+
+          Buffer* GetPooled();
+          void Recycle(Buffer* buffer);
+          void Push(Buffer* buffer);
+          Buffer* Pop(std::chrono::milliseconds timeout);
+      };
+
+    }  // namespace Detail
+
+
+    const std::chrono::milliseconds LocalDummyDefaultReceiveTimeout = InfiniteReceiveTimeout;
+
+
+    // pair of in-process transports, for tests and in-process services
     class LocalDummyTransport
     {
         template <InterfaceMode Mode>
         class LocalDummyTransportImpl : public Transport<Mode>
         {
           public:
-            LocalDummyTransportImpl(LocalDummyTransport& parent)
-            : Transport(), m_Parent(parent)
+            LocalDummyTransportImpl(Detail::LocalChannel& sendChannel, Detail::LocalChannel& receiveChannel, std::chrono::milliseconds receiveTimeout)
+            : Transport<Mode>(), m_SendChannel(sendChannel), m_ReceiveChannel(receiveChannel), m_ReceiveTimeout(receiveTimeout)
             {}
 
             virtual void Send(const Buffer& data) override
             {
-#pragma warning(suppress: 4127)  // conditional expression is constant
-              if (Mode == InterfaceMode::Client)
-              {
-                m_Parent.ClientSend(data);
-              }
-              else
-              {
-                m_Parent.ServerSend(data);
-              }
+              m_SendChannel.Send(data);
+            }
+
+            virtual void Send(Buffer&& data) override
+            {
+              m_SendChannel.Send(std::move(data));
+            }
+
+            virtual void Send(const typename Transport<Mode>::Segments& segments) override
+            {
+              m_SendChannel.Send(segments);
+            }
+
+            virtual Buffer Acquire() override
+            {
+              return m_SendChannel.Acquire();
+            }
+
+            virtual void Commit(Buffer&& data) override
+            {
+              m_SendChannel.Send(std::move(data));
             }
 
             virtual bool Receive(Buffer& data) override
             {
-#pragma warning(suppress: 4127)  // conditional expression is constant
-              if (Mode == InterfaceMode::Client)
-              {
-                return m_Parent.ClientReceive(data);
-              }
-              else
-              {
-                return m_Parent.ServerReceive(data);
-              }
+              return m_ReceiveChannel.Receive(data, m_ReceiveTimeout);
+            }
+
+            virtual bool ReceiveLent(BufferView& data) override
+            {
+              return m_ReceiveChannel.ReceiveLent(data, m_ReceiveTimeout);
+            }
+
+            virtual void Return() override
+            {
+              m_ReceiveChannel.Return();
+            }
+
+            virtual void Interrupt() override
+            {
+              m_ReceiveChannel.Interrupt();
             }
 
           private:
-            LocalDummyTransport& m_Parent;
+            Detail::LocalChannel&     m_SendChannel;
+            Detail::LocalChannel&     m_ReceiveChannel;
+            std::chrono::milliseconds m_ReceiveTimeout;
         };
 
         using ClientImplementation = LocalDummyTransportImpl<InterfaceMode::Client>;
         using ServerImplementation = LocalDummyTransportImpl<InterfaceMode::Server>;
 
       public:
-        LocalDummyTransport();
+        explicit LocalDummyTransport(std::chrono::milliseconds receiveTimeout = LocalDummyDefaultReceiveTimeout);
 
         ClientImplementation& GetClientTransport()
         {
@@ -90,31 +352,11 @@ namespace CppRpc
         }
 
       protected:
-        // TODO: probably make timeout an parameter!?
-        static const unsigned Timeout = 250;  // in milliseconds
-
-        using Mutex = std::recursive_mutex;
-        using Lock = std::unique_lock<Mutex>;
-        using ConditionVariable = std::condition_variable_any;
-
-        using Queue = std::list<Buffer>;
-
-        Mutex m_Mutex;
-        ConditionVariable m_ClientToServerQueueCondVar;
-        ConditionVariable m_ServerToClientQueueCondVar;
-
-        Queue m_ClientToServerQueue;
-        Queue m_ServerToClientQueue;
+        Detail::LocalChannel m_ClientToServerChannel;
+        Detail::LocalChannel m_ServerToClientChannel;
 
         ServerImplementation m_Server;
         ClientImplementation m_Client;
-
-        void ClientSend(const Buffer& data);
-        bool ClientReceive(Buffer& data);
-
-        void ServerSend(const Buffer& data);
-        bool ServerReceive(Buffer& data);
-
     };
 
   }  // namespace V1
@@ -6,6 +6,10 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+#include "cpprpc/Buffer.h"
 
 
 namespace CppRpc
@@ -15,11 +19,21 @@ namespace CppRpc
 
     enum class InterfaceMode { Client, Server };
 
-    using Name = std::string;
+    // marks a function as one-way (no result, the client does not wait for the call), pass as last argument when creating the function
+    struct OneWayFunctionTag {};
+
+    constexpr OneWayFunctionTag OneWay = {};
 
-    using Byte = std::uint8_t;
+    // where a server with worker threads executes the calls of a function, pass as last argument when creating the (server side) function;
+    // servers without worker threads execute all calls on the thread receiving them
+    enum class ExecutionPolicy
+    {
+      Offload,  // on the worker threads, for functions that must not stall the receiving thread (default)
+      Inline,   // on the receiving thread, for trivial functions executing faster than a hand-off to another thread
+      Adaptive  // inline while measured to be that fast, offloaded otherwise (re-measured every now and then)
+    };
 
-    using Buffer = std::vector<Byte>;
+    using Name = std::string;
 
     struct Version
     {
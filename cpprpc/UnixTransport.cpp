@@ -0,0 +1,125 @@
+#include "cpprpc/UnixTransport.h"
+
+#if defined(__linux__)
+
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <boost/format.hpp>
+
+#include "cpprpc/Exception.h"
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    namespace
+    {
+
+      using Detail::ThrowTransportError;
+
+      sockaddr_un GetAddress(const std::string& path)
+      {
+        sockaddr_un address = {};
+
+        address.sun_family = AF_UNIX;
+
+        if (path.empty() || (path.size() >= sizeof(address.sun_path)))
+        {
+          throw Detail::ExceptionImpl<TransportError>((boost::format("Invalid socket path \"%1%\"") % path).str());
+        }
+
+        std::memcpy(address.sun_path, path.data(), path.size());
+
+        return address;
+      }
+
+      // returns non-blocking socket connected to path
+      int Connect(const std::string& path)
+      {
+        const sockaddr_un address = GetAddress(path);
+
+        Detail::FileDescriptor socket(::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+
+        if (socket.Get() < 0)
+        {
+          ThrowTransportError("Unable to create socket");
+        }
+
+        if (connect(socket.Get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+          ThrowTransportError((boost::format("Unable to connect to \"%1%\"") % path).str());
+        }
+
+        // switch to non-blocking after connecting
+        const int flags = fcntl(socket.Get(), F_GETFL);
+
+        if ((flags < 0) || (fcntl(socket.Get(), F_SETFL, flags | O_NONBLOCK) != 0))
+        {
+          ThrowTransportError("Unable to make socket non-blocking");
+        }
+
+        return socket.Release();
+      }
+
+      // returns non-blocking socket listening on path
+      int Listen(const std::string& path)
+      {
+        const sockaddr_un address = GetAddress(path);
+
+        Detail::FileDescriptor listener(socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+
+        if (listener.Get() < 0)
+        {
+          ThrowTransportError("Unable to create socket");
+        }
+
+        // remove stale socket file of a previous server
+        unlink(path.c_str());
+
+        if (bind(listener.Get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+          ThrowTransportError((boost::format("Unable to bind to \"%1%\"") % path).str());
+        }
+
+        if (listen(listener.Get(), SOMAXCONN) != 0)
+        {
+          const int error = errno;
+
+          unlink(path.c_str());
+
+          ThrowTransportError("Unable to listen", error);
+        }
+
+        return listener.Release();
+      }
+
+    }  // anonymous namespace
+
+
+    UnixClientTransport::UnixClientTransport(const std::string& path, std::size_t fileThreshold, std::chrono::milliseconds receiveTimeout, IoEngineType ioEngine,
+                                             std::chrono::milliseconds sendTimeout)
+    : Detail::StreamClientTransport(Connect(path), true, fileThreshold, receiveTimeout, ioEngine, sendTimeout)
+    {}
+
+
+    UnixServerTransport::UnixServerTransport(const std::string& path, std::size_t fileThreshold, std::chrono::milliseconds receiveTimeout, IoEngineType ioEngine,
+                                             std::chrono::milliseconds sendTimeout)
+    : Detail::StreamServerTransport(Listen(path), true, fileThreshold, receiveTimeout, ioEngine, sendTimeout), m_Path(path)
+    {}
+
+    UnixServerTransport::~UnixServerTransport() noexcept
+    {
+      unlink(m_Path.c_str());
+    }
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
@@ -0,0 +1,60 @@
+#ifndef CPPRPC_UNIXTRANSPORT_H
+#define CPPRPC_UNIXTRANSPORT_H
+
+#pragma once
+
+// Unix domain socket transport is built on epoll / io_uring and memfd, Linux only for now
+#if defined(__linux__)
+
+#include <string>
+#include <chrono>
+#include <cstddef>
+
+#include "cpprpc/StreamTransport.h"
+
+namespace CppRpc
+{
+  inline namespace V1
+  {
+
+    // frames of at least this size are handed over as sealed memfd instead of being copied through the socket
+    const std::size_t UnixDefaultFileThreshold = 256 * 1024;
+
+    const std::chrono::milliseconds UnixDefaultReceiveTimeout = InfiniteReceiveTimeout;
+    const std::chrono::milliseconds UnixDefaultSendTimeout = StreamDefaultSendTimeout;
+
+
+    // connects to a UnixServerTransport listening on path on construction
+    class UnixClientTransport : public Detail::StreamClientTransport
+    {
+      public:
+        // fileThreshold 0 sends all frames through the socket
+        explicit UnixClientTransport(const std::string& path, std::size_t fileThreshold = UnixDefaultFileThreshold,
+                                     std::chrono::milliseconds receiveTimeout = UnixDefaultReceiveTimeout, IoEngineType ioEngine = IoEngineType::Automatic,
+                                     std::chrono::milliseconds sendTimeout = UnixDefaultSendTimeout);
+
+        virtual ~UnixClientTransport() noexcept override = default;
+    };
+
+
+    // listens on path (replacing a stale socket file), serves any number of connections at once, the socket file is removed on destruction
+    class UnixServerTransport : public Detail::StreamServerTransport
+    {
+      public:
+        // fileThreshold 0 sends all frames through the socket
+        explicit UnixServerTransport(const std::string& path, std::size_t fileThreshold = UnixDefaultFileThreshold,
+                                     std::chrono::milliseconds receiveTimeout = UnixDefaultReceiveTimeout, IoEngineType ioEngine = IoEngineType::Automatic,
+                                     std::chrono::milliseconds sendTimeout = UnixDefaultSendTimeout);
+
+        virtual ~UnixServerTransport() noexcept override;
+
+      private:
+        std::string m_Path;
+    };
+
+  }  // namespace V1
+}  // namespace CppRpc
+
+#endif  // __linux__
+
+#endif